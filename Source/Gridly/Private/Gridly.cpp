@@ -3,6 +3,9 @@
 #include "Gridly.h"
 
 #include "../Public/GridlyGameSettings.h"
+#include "../Public/GridlyHttpClient.h"
+#include "../Public/GridlyRateLimiter.h"
+#include "../Public/GridlyResponseCache.h"
 #include "Core/Public/Modules/ModuleManager.h"
 
 #if WITH_EDITOR
@@ -17,6 +20,11 @@ DEFINE_LOG_CATEGORY(LogGridly);
 
 void FGridlyModule::StartupModule()
 {
+	if (FGridlyResponseCache::IsEnabled())
+	{
+		FGridlyResponseCache::Prune();
+	}
+
 #if WITH_EDITOR
 	// Register project settings
 
@@ -42,6 +50,9 @@ void FGridlyModule::StartupModule()
 
 void FGridlyModule::ShutdownModule()
 {
+	FGridlyHttpClient::Get().Shutdown();
+	FGridlyRateLimiter::Get().Shutdown();
+
 #if WITH_EDITOR
 	if (ISettingsModule* SettingsModule = FModuleManager::GetModulePtr<ISettingsModule>("Settings"))
 	{
@@ -2,19 +2,17 @@
 
 #include "GridlyTask_DownloadLocalizedTexts.h"
 
-#include "Engine/EngineTypes.h"
-#include "Engine/World.h"
-#include "TimerManager.h"
 #include "Gridly.h"
+#include "GridlyColumnSchema.h"
 #include "GridlyGameSettings.h"
+#include "GridlyHttpCompression.h"
 #include "GridlyLocalizedTextConverter.h"
+#include "GridlyRecordsParser.h"
 #include "GridlyTableRow.h"
-#include "HttpModule.h"
-#include "JsonObjectConverter.h"
-#include "GenericPlatform/GenericPlatformHttp.h"
 #include "Runtime/Online/HTTP/Public/Interfaces/IHttpResponse.h"
 
-UGridlyTask_DownloadLocalizedTexts::UGridlyTask_DownloadLocalizedTexts()
+UGridlyTask_DownloadLocalizedTexts::UGridlyTask_DownloadLocalizedTexts() :
+	RequestPriority(EGridlyRequestPriority::Background)
 {
 	if (!HasAnyFlags(RF_ClassDefaultObject))
 	{
@@ -26,8 +24,13 @@ void UGridlyTask_DownloadLocalizedTexts::Activate()
 {
 	const UGridlyGameSettings* GameSettings = GetMutableDefault<UGridlyGameSettings>();
 
-	Limit = GameSettings->ImportMaxRecordsPerRequest;
+	Limit = FMath::Max(1, GameSettings->ImportMaxRecordsPerRequest);
+	MaxConcurrentRequests = FMath::Max(1, GameSettings->ImportMaxConcurrentRequests);
 	TotalCount = 0;
+	ReceivedCount = 0;
+	bFailed = false;
+	bUseIncrementalImport = GameSettings->bUseIncrementalImport;
+	ThrottleTime = 0.f;
 
 	ViewIds.Reset();
 	for (int i = 0; i < GameSettings->ImportFromViewIds.Num(); i++)
@@ -38,86 +41,111 @@ void UGridlyTask_DownloadLocalizedTexts::Activate()
 		}
 	}
 
+	PageRequests.Reset();
+	CompletedPages.Reset();
 	PolyglotTextDatas.Reset();
+	ColumnSchema = MakeShared<FGridlyColumnSchema>();
+
+	ColumnIds.Reset();
+	if (GameSettings->bImportUsedColumnsOnly && !ColumnSchema->GetColumnIds(Cultures, ColumnIds))
+	{
+		UE_LOG(LogGridly, Log, TEXT("Not every culture maps to a Gridly column, downloading all columns"));
+		ColumnIds.Reset();
+	}
 
 	RequestPage(0, 0);
 }
 
 void UGridlyTask_DownloadLocalizedTexts::RequestPage(const int ViewIdIndex, const int Offset)
 {
-	CurrentViewIdIndex = ViewIdIndex;
-	CurrentOffset = Offset;
-
 	if (ViewIds.Num() == 0)
 	{
 		const FGridlyResult FailResult = FGridlyResult{"Unable to import texts: no view IDs were specified"};
 		UE_LOG(LogGridly, Error, TEXT("%s"), *FailResult.Message);
-		OnFail.Broadcast(PolyglotTextDatas, 1.f, FailResult);
-		if (OnFailDelegate.IsBound())
-			OnFailDelegate.Execute(PolyglotTextDatas, FailResult);
+		Fail(FailResult);
 		return;
 	}
 
+	const int PageIndex = Offset / Limit;
+
+	if (PageIndex == 0)
+	{
+		// The amount of pages is unknown until the first page of the view has been received
+
+		CurrentViewIdIndex = ViewIdIndex;
+		CurrentViewPageCount = 1;
+		NextPageIndex = 1;
+		NextPageToAppend = 0;
+		CompletedPages.Reset();
+
+		if (bUseIncrementalImport && ViewIdIndex < ViewIds.Num())
+		{
+			SyncState.Load(TEXT("Localization"), ViewIds[ViewIdIndex], ColumnIds);
+			ChangedCount = 0;
+		}
+	}
+
 	if (ViewIdIndex < ViewIds.Num())
 	{
 		const FString& ViewId = ViewIds[ViewIdIndex];
 
 		const UGridlyGameSettings* GameSettings = GetMutableDefault<UGridlyGameSettings>();
-		const FString ApiKey = GameSettings->ImportApiKey;
-
-		const FString PaginationSettings =
-			FGenericPlatformHttp::UrlEncode(FString::Printf(TEXT("{\"offset\":%d,\"limit\":%d}"), Offset, Limit));
-
-		FStringFormatNamedArguments Args;
-		Args.Add(TEXT("ViewId"), *ViewId);
-		Args.Add(TEXT("PaginationSettings"), *PaginationSettings);
-		const FString Url = FString::Format(TEXT("https://api.gridly.com/v1/views/{ViewId}/records?page={PaginationSettings}"),
-			Args);
 
-		HttpRequest = FHttpModule::Get().CreateRequest();
-		HttpRequest->SetHeader(TEXT("Accept"), TEXT("application/json"));
-		HttpRequest->SetHeader(TEXT("Content-Type"), TEXT("application/json"));
-		HttpRequest->SetHeader(TEXT("Authorization"), FString::Printf(TEXT("ApiKey %s"), *ApiKey));
+		FString Query;
+		if (bUseIncrementalImport)
+		{
+			SyncState.GetChangedRecordsQuery(Query);
+		}
 
-		HttpRequest->SetVerb(TEXT("GET"));
-		HttpRequest->SetURL(Url);
+		const FString Url = FGridlyHttpClient::GetViewRecordsPageUrl(ViewId, Offset, Limit, Query, ColumnIds);
+		const FHttpRequestPtr HttpRequest = FGridlyHttpClient::CreateRequest(TEXT("GET"), Url, GameSettings->ImportApiKey);
 
-		HttpRequest->OnProcessRequestComplete().BindUObject(this, &UGridlyTask_DownloadLocalizedTexts::OnProcessRequestComplete);
+		if (PageIndex == 0)
+		{
+			OnProgress.Broadcast(PolyglotTextDatas, .1f, FGridlyResult::Success);
+			if (OnProgressDelegate.IsBound())
+				OnProgressDelegate.Execute(PolyglotTextDatas, .1f);
+		}
 
-		OnProgress.Broadcast(PolyglotTextDatas, .1f, FGridlyResult::Success);
-		if (OnProgressDelegate.IsBound())
-			OnProgressDelegate.Execute(PolyglotTextDatas, .1f);
+		// Throttling and retries are left to the shared HTTP client, which never blocks the calling thread
 
-		// Throttles number of requests by sleeping between each
+		UE_LOG(LogGridly, Log, TEXT("Requesting view ID: %s, with offset: %d, limit: %d"), *ViewId, Offset, Limit);
 
-		UWorld* World = WorldContextObject != nullptr ? WorldContextObject->GetWorld() : nullptr;
-		if (World)
-		{
-			FTimerHandle TimerHandle;
-			World->GetTimerManager().SetTimer(TimerHandle, [this, ViewId, Offset]()
-			{
-				HttpRequest->ProcessRequest();
-				UE_LOG(LogGridly, Log, TEXT("Requesting view ID: %s, with offset: %d, limit: %d"), *ViewId, Offset, Limit);
-			}, 1.f, false);
-		}
-		else
-		{
-			HttpRequest->ProcessRequest();
-			UE_LOG(LogGridly, Log, TEXT("Requesting view ID: %s, with offset: %d, limit: %d"), *ViewId, Offset, Limit);
-			FPlatformProcess::Sleep(1.f);
-		}
+		PageRequests.Add(PageIndex, FGridlyHttpClient::Get().Send(HttpRequest, RequestPriority,
+			FGridlyRequestCompleteDelegate::CreateUObject(this, &UGridlyTask_DownloadLocalizedTexts::OnProcessRequestComplete,
+				ViewIdIndex, PageIndex)));
 	}
 	else
 	{
+		UE_LOG(LogGridly, Log, TEXT("Downloaded %d texts, requests were throttled for %.2f seconds"), PolyglotTextDatas.Num(),
+			ThrottleTime);
+
 		OnSuccess.Broadcast(PolyglotTextDatas, 1.f, FGridlyResult::Success);
 		if (OnSuccessDelegate.IsBound())
 			OnSuccessDelegate.Execute(PolyglotTextDatas);
 	}
 }
 
+void UGridlyTask_DownloadLocalizedTexts::RequestRemainingPages()
+{
+	while (PageRequests.Num() < MaxConcurrentRequests && NextPageIndex < CurrentViewPageCount)
+	{
+		RequestPage(CurrentViewIdIndex, NextPageIndex * Limit);
+		NextPageIndex++;
+	}
+}
+
 void UGridlyTask_DownloadLocalizedTexts::OnProcessRequestComplete(FHttpRequestPtr HttpRequestPtr,
-	FHttpResponsePtr HttpResponsePtr, bool bSuccess)
+	FHttpResponsePtr HttpResponsePtr, bool bSuccess, const FGridlyRequestTiming& Timing, int ViewIdIndex, int PageIndex)
 {
+	if (bFailed || ViewIdIndex != CurrentViewIdIndex)
+	{
+		return;
+	}
+
+	PageRequests.Remove(PageIndex);
+	ThrottleTime += Timing.ThrottleTime;
+
 	if (bSuccess && HttpResponsePtr->GetResponseCode() == EHttpResponseCodes::Ok)
 	{
 		// Header
@@ -130,54 +158,147 @@ void UGridlyTask_DownloadLocalizedTexts::OnProcessRequestComplete(FHttpRequestPt
 
 		// Convert from JSON to texts
 
-		const FString Content = HttpResponsePtr->GetContentAsString();
-		UE_LOG(LogGridly, Verbose, TEXT("%s"), *Content);
+		if (UE_LOG_ACTIVE(LogGridly, Verbose))
+		{
+			UE_LOG(LogGridly, Verbose, TEXT("%s"), *FGridlyHttpCompression::GetContentAsString(HttpResponsePtr));
+		}
+
+		// Compressed pages are inflated into a buffer and parsed from there, without going through a string
 
-		TMap<FString, FPolyglotTextData> PolyglotTextDataMap;
+		TArray<uint8> DecompressedContent;
 		TArray<FGridlyTableRow> TableRows;
 
-		if (FJsonObjectConverter::JsonArrayStringToUStruct(Content, &TableRows, 0, 0)
-		    && FGridlyLocalizedTextConverter::TableRowsToPolyglotTextDatas(TableRows, PolyglotTextDataMap))
+		if (FGridlyRecordsParser::Parse(FGridlyHttpCompression::GetContent(HttpResponsePtr, DecompressedContent), TableRows))
 		{
-			TArray<FPolyglotTextData> CurrentPolyglotTextDatas;
-			PolyglotTextDataMap.GenerateValueArray(CurrentPolyglotTextDatas);
-			PolyglotTextDatas.Append(CurrentPolyglotTextDatas);
+			ReceivedCount += TableRows.Num();
+			CompletedPages.Add(PageIndex, MoveTemp(TableRows));
+
+			if (PageIndex == 0)
+			{
+				const int ViewIdTotalCount = FCString::Atoi(*HttpResponsePtr->GetHeader("X-Total-Count"));
+				TotalCount += ViewIdTotalCount;
+				CurrentViewPageCount = FMath::Max(1, FMath::DivideAndRoundUp(ViewIdTotalCount, Limit));
+			}
+
+			// Reassemble pages in order, regardless of which one finished first
+
+			while (TArray<FGridlyTableRow>* NextTableRows = CompletedPages.Find(NextPageToAppend))
+			{
+				if (!AppendRows(*NextTableRows))
+				{
+					Fail(FGridlyResult{"Failed to parse downloaded content"});
+					return;
+				}
+
+				CompletedPages.Remove(NextPageToAppend);
+				NextPageToAppend++;
+			}
 
-			const int ViewIdTotalCount = FCString::Atoi(*HttpResponsePtr->GetHeader("X-Total-Count"));
-			TotalCount += CurrentOffset == 0 ? ViewIdTotalCount : 0;
 			const float EstimatedProgressViewIds =
 				static_cast<float>(CurrentViewIdIndex) / static_cast<float>(FMath::Max(1, ViewIds.Num()));
-			const float EstimatedProgressPagination = static_cast<float>(PolyglotTextDatas.Num()) / static_cast<float>(TotalCount);
+			const float EstimatedProgressPagination =
+				static_cast<float>(ReceivedCount) / static_cast<float>(FMath::Max(1, TotalCount));
 			const float EstimatedProgress = (EstimatedProgressViewIds + EstimatedProgressPagination) / 2.f;
-			
+
 			OnProgress.Broadcast(PolyglotTextDatas, EstimatedProgress, FGridlyResult::Success);
 			if (OnProgressDelegate.IsBound())
 				OnProgressDelegate.Execute(PolyglotTextDatas, EstimatedProgress);
 
-			if ((CurrentOffset + Limit) < TotalCount)
+			if (NextPageToAppend < CurrentViewPageCount)
 			{
-				RequestPage(CurrentViewIdIndex, CurrentOffset + Limit);
+				RequestRemainingPages();
 			}
-			else
+			else if (FinishView())
 			{
 				RequestPage(CurrentViewIdIndex + 1, 0);
 			}
+			else
+			{
+				Fail(FGridlyResult{"Failed to parse downloaded content"});
+			}
 		}
 		else
 		{
-			const FGridlyResult FailResult = FGridlyResult{"Failed to parse downloaded content"};
-			OnFail.Broadcast(PolyglotTextDatas, 1.f, FailResult);
-			if (OnFailDelegate.IsBound())
-				OnFailDelegate.Execute(PolyglotTextDatas, FailResult);
+			Fail(FGridlyResult{"Failed to parse downloaded content"});
 		}
 	}
 	else
 	{
-		const FGridlyResult FailResult = FGridlyResult{"Failed to connect to Gridly"};
-		OnFail.Broadcast(PolyglotTextDatas, 1.f, FailResult);
-		if (OnFailDelegate.IsBound())
-			OnFailDelegate.Execute(PolyglotTextDatas, FailResult);
+		Fail(FGridlyResult{"Failed to connect to Gridly"});
+	}
+}
+
+bool UGridlyTask_DownloadLocalizedTexts::AppendRows(const TArray<FGridlyTableRow>& TableRows)
+{
+	if (bUseIncrementalImport)
+	{
+		ChangedCount += SyncState.MergeRows(TableRows);
+		return true;
+	}
+
+	TMap<FString, FPolyglotTextData> PolyglotTextDataMap;
+	if (FGridlyLocalizedTextConverter::TableRowsToPolyglotTextDatas(*ColumnSchema, TableRows, PolyglotTextDataMap))
+	{
+		TArray<FPolyglotTextData> PagePolyglotTextDatas;
+		PolyglotTextDataMap.GenerateValueArray(PagePolyglotTextDatas);
+		PolyglotTextDatas.Append(MoveTemp(PagePolyglotTextDatas));
+		return true;
 	}
+
+	return false;
+}
+
+bool UGridlyTask_DownloadLocalizedTexts::FinishView()
+{
+	if (!bUseIncrementalImport)
+	{
+		return true;
+	}
+
+	SyncState.Finish();
+	SyncState.Save();
+
+	UE_LOG(LogGridly, Log, TEXT("View ID %s: %d of %d records changed since the last import"), *SyncState.ViewId, ChangedCount,
+		SyncState.Num());
+
+	if (SyncState.Num() == 0)
+	{
+		return true;
+	}
+
+	// The texts are rebuilt from the whole synced set, so the result is the same as a full import
+
+	TArray<FGridlyTableRow> TableRows;
+	SyncState.GetRows(TableRows);
+
+	TMap<FString, FPolyglotTextData> PolyglotTextDataMap;
+	if (FGridlyLocalizedTextConverter::TableRowsToPolyglotTextDatas(*ColumnSchema, TableRows, PolyglotTextDataMap))
+	{
+		TArray<FPolyglotTextData> ViewPolyglotTextDatas;
+		PolyglotTextDataMap.GenerateValueArray(ViewPolyglotTextDatas);
+		PolyglotTextDatas.Append(MoveTemp(ViewPolyglotTextDatas));
+		return true;
+	}
+
+	return false;
+}
+
+void UGridlyTask_DownloadLocalizedTexts::Fail(const FGridlyResult& FailResult)
+{
+	bFailed = true;
+
+	// Cancel the pages that are still in flight or queued, their responses are ignored
+
+	for (const TPair<int, FGridlyRequestId>& PageRequest : PageRequests)
+	{
+		FGridlyHttpClient::Get().Cancel(PageRequest.Value);
+	}
+
+	PageRequests.Reset();
+
+	OnFail.Broadcast(PolyglotTextDatas, 1.f, FailResult);
+	if (OnFailDelegate.IsBound())
+		OnFailDelegate.Execute(PolyglotTextDatas, FailResult);
 }
 
 UGridlyTask_DownloadLocalizedTexts* UGridlyTask_DownloadLocalizedTexts::DownloadLocalizedTexts(const UObject* WorldContextObject)
@@ -2,19 +2,16 @@
 
 #include "GridlyTask_ImportDataTableFromGridly.h"
 
-#include "Engine/EngineTypes.h"
-#include "Engine/World.h"
-#include "TimerManager.h"
 #include "GridlyDataTableImporterJSON.h"
 #include "Gridly.h"
 #include "GridlyGameSettings.h"
+#include "GridlyHttpCompression.h"
+#include "GridlyRecordsParser.h"
 #include "GridlyTableRow.h"
-#include "HttpModule.h"
-#include "JsonObjectConverter.h"
-#include "GenericPlatform/GenericPlatformHttp.h"
 #include "Runtime/Online/HTTP/Public/Interfaces/IHttpResponse.h"
 
-UGridlyTask_ImportDataTableFromGridly::UGridlyTask_ImportDataTableFromGridly()
+UGridlyTask_ImportDataTableFromGridly::UGridlyTask_ImportDataTableFromGridly() :
+	RequestPriority(EGridlyRequestPriority::Background)
 {
 	if (!HasAnyFlags(RF_ClassDefaultObject))
 	{
@@ -28,6 +25,9 @@ void UGridlyTask_ImportDataTableFromGridly::Activate()
 
 	Limit = GameSettings->ImportMaxRecordsPerRequest;
 	TotalCount = 0;
+	ReceivedCount = 0;
+	ThrottleTime = 0.f;
+	bUseIncrementalImport = GameSettings->bUseIncrementalImport;
 
 	ViewIds.Reset();
 	if (GridlyDataTable && !GridlyDataTable->ViewId.IsEmpty())
@@ -35,6 +35,12 @@ void UGridlyTask_ImportDataTableFromGridly::Activate()
 		ViewIds.Add(GridlyDataTable->ViewId);
 	}
 
+	ColumnIds.Reset();
+	if (GameSettings->bImportUsedColumnsOnly && GridlyDataTable)
+	{
+		GridlyDataTableJSONUtils::GetImportColumnIds(*GridlyDataTable, ColumnIds);
+	}
+
 	GridlyTableRows.Reset();
 
 	RequestPage(0, 0);
@@ -59,79 +65,45 @@ void UGridlyTask_ImportDataTableFromGridly::RequestPage(const int ViewIdIndex, c
 	{
 		const FString& ViewId = ViewIds[ViewIdIndex];
 
-		const UGridlyGameSettings* GameSettings = GetMutableDefault<UGridlyGameSettings>();
-		const FString ApiKey = GameSettings->ImportApiKey;
-
-		const FString PaginationSettings = FGenericPlatformHttp::UrlEncode(FString::Printf(TEXT("{\"offset\":%d,\"limit\":%d}"),
-			Offset,
-			Limit));
-
-		FStringFormatNamedArguments Args;
-		Args.Add(TEXT("ViewId"), *ViewId);
-		Args.Add(TEXT("PaginationSettings"), *PaginationSettings);
-		const FString Url = FString::Format(TEXT("https://api.gridly.com/v1/views/{ViewId}/records?page={PaginationSettings}"),
-			Args);
+		if (bUseIncrementalImport && Offset == 0)
+		{
+			SyncState.Load(TEXT("DataTable"), ViewId, ColumnIds);
+			ChangedCount = 0;
+		}
 
-		HttpRequest = FHttpModule::Get().CreateRequest();
-		HttpRequest->SetHeader(TEXT("Accept"), TEXT("application/json"));
-		HttpRequest->SetHeader(TEXT("Content-Type"), TEXT("application/json"));
-		HttpRequest->SetHeader(TEXT("Authorization"), FString::Printf(TEXT("ApiKey %s"), *ApiKey));
+		const UGridlyGameSettings* GameSettings = GetMutableDefault<UGridlyGameSettings>();
 
-		HttpRequest->SetVerb(TEXT("GET"));
-		HttpRequest->SetURL(Url);
+		FString Query;
+		if (bUseIncrementalImport)
+		{
+			SyncState.GetChangedRecordsQuery(Query);
+		}
 
-		HttpRequest->OnProcessRequestComplete().BindUObject(this, &UGridlyTask_ImportDataTableFromGridly::OnProcessRequestComplete);
+		const FString Url = FGridlyHttpClient::GetViewRecordsPageUrl(ViewId, Offset, Limit, Query, ColumnIds);
+		const FHttpRequestPtr HttpRequest = FGridlyHttpClient::CreateRequest(TEXT("GET"), Url, GameSettings->ImportApiKey);
 
 		OnProgress.Broadcast(GridlyTableRows, .1f, FGridlyResult::Success);
 		if (OnProgressDelegate.IsBound())
 			OnProgressDelegate.Execute(GridlyTableRows, .1f);
 
-		// Throttles number of requests by sleeping between each
+		// Throttling and retries are left to the shared HTTP client, which never blocks the calling thread
 
-		UWorld* World = WorldContextObject != nullptr ? WorldContextObject->GetWorld() : nullptr;
-		if (World)
-		{
-			FTimerHandle TimerHandle;
-			World->GetTimerManager().SetTimer(TimerHandle, [this, ViewId, Offset]()
-			{
-				HttpRequest->ProcessRequest();
-				UE_LOG(LogGridly, Log, TEXT("Requesting view ID: %s, with offset: %d, limit: %d"), *ViewId, Offset, Limit);
-			}, 1.f, false);
-		}
-		else
-		{
-			HttpRequest->ProcessRequest();
-			UE_LOG(LogGridly, Log, TEXT("Requesting view ID: %s, with offset: %d, limit: %d"), *ViewId, Offset, Limit);
-			FPlatformProcess::Sleep(1.f);
-		}
+		UE_LOG(LogGridly, Log, TEXT("Requesting view ID: %s, with offset: %d, limit: %d"), *ViewId, Offset, Limit);
+
+		FGridlyHttpClient::Get().Send(HttpRequest, RequestPriority,
+			FGridlyRequestCompleteDelegate::CreateUObject(this, &UGridlyTask_ImportDataTableFromGridly::OnProcessRequestComplete));
 	}
 	else
 	{
-		TArray<TSharedPtr<FJsonValue>> JsonValues;
+		const bool bPatchRows = GetMutableDefault<UGridlyGameSettings>()->bPatchDataTablesOnImport;
 
-		for (int i = 0; i < GridlyTableRows.Num(); i++)
-		{
-			const TSharedPtr<FJsonObject> JsonObject = MakeShareable(new FJsonObject);
-			JsonObject->SetStringField("name", GridlyTableRows[i].Id);
-
-			for (int j = 0; j < GridlyTableRows[i].Cells.Num(); j++)
-			{
-				JsonObject->SetStringField(GridlyTableRows[i].Cells[j].ColumnId, GridlyTableRows[i].Cells[j].Value);
-			}
-
-			JsonValues.Add(MakeShareable(new FJsonValueObject(JsonObject)));
-		}
-
-		GridlyDataTable->EmptyTable();
-
-		FString JsonString;
-		const TSharedRef<TJsonWriter<>> JsonWriter = TJsonStringWriter<>::Create(&JsonString);
-		FJsonSerializer::Serialize(JsonValues, JsonWriter);
+		// The downloaded rows replace those of the table directly, without going through JSON
 
 		TArray<FString> OutProblems;
-		if (FGridlyDataTableImporterJSON(*GridlyDataTable, JsonString, OutProblems).ReadTable())
+		if (FGridlyDataTableImporterJSON(*GridlyDataTable, GridlyTableRows, OutProblems, bPatchRows).ReadTable())
 		{
-			UE_LOG(LogGridly, Log, TEXT("Imported data table from Gridly: %s"), *GridlyDataTable->GetName());
+			UE_LOG(LogGridly, Log, TEXT("Imported data table from Gridly: %s, requests were throttled for %.2f seconds"),
+				*GridlyDataTable->GetName(), ThrottleTime);
 			OnSuccess.Broadcast(GridlyTableRows, 1.f, FGridlyResult::Success);
 			if (OnSuccessDelegate.IsBound())
 				OnSuccessDelegate.Execute(GridlyTableRows);
@@ -152,8 +124,10 @@ void UGridlyTask_ImportDataTableFromGridly::RequestPage(const int ViewIdIndex, c
 }
 
 void UGridlyTask_ImportDataTableFromGridly::OnProcessRequestComplete(FHttpRequestPtr HttpRequestPtr,
-	FHttpResponsePtr HttpResponsePtr, bool bSuccess)
+	FHttpResponsePtr HttpResponsePtr, bool bSuccess, const FGridlyRequestTiming& Timing)
 {
+	ThrottleTime += Timing.ThrottleTime;
+
 	if (bSuccess && HttpResponsePtr->GetResponseCode() == EHttpResponseCodes::Ok)
 	{
 		// Header
@@ -166,20 +140,34 @@ void UGridlyTask_ImportDataTableFromGridly::OnProcessRequestComplete(FHttpReques
 
 		// Convert from JSON to texts
 
-		const FString Content = HttpResponsePtr->GetContentAsString();
-		UE_LOG(LogGridly, Verbose, TEXT("%s"), *Content);
+		if (UE_LOG_ACTIVE(LogGridly, Verbose))
+		{
+			UE_LOG(LogGridly, Verbose, TEXT("%s"), *FGridlyHttpCompression::GetContentAsString(HttpResponsePtr));
+		}
+
+		// Compressed pages are inflated into a buffer and parsed from there, without going through a string
 
+		TArray<uint8> DecompressedContent;
 		TArray<FGridlyTableRow> TableRows;
 
-		if (FJsonObjectConverter::JsonArrayStringToUStruct(Content, &TableRows, 0, 0))
+		if (FGridlyRecordsParser::Parse(FGridlyHttpCompression::GetContent(HttpResponsePtr, DecompressedContent), TableRows))
 		{
-			GridlyTableRows.Append(TableRows);
+			ReceivedCount += TableRows.Num();
+			if (bUseIncrementalImport)
+			{
+				ChangedCount += SyncState.MergeRows(TableRows);
+			}
+			else
+			{
+				GridlyTableRows.Append(TableRows);
+			}
 
 			const int ViewIdTotalCount = FCString::Atoi(*HttpResponsePtr->GetHeader("X-Total-Count"));
 			TotalCount += CurrentOffset == 0 ? ViewIdTotalCount : 0;
 			const float EstimatedProgressViewIds =
 				static_cast<float>(CurrentViewIdIndex) / static_cast<float>(FMath::Max(1, ViewIds.Num()));
-			const float EstimatedProgressPagination = static_cast<float>(GridlyTableRows.Num()) / static_cast<float>(TotalCount);
+			const float EstimatedProgressPagination =
+				static_cast<float>(ReceivedCount) / static_cast<float>(FMath::Max(1, TotalCount));
 			const float EstimatedProgress = (EstimatedProgressViewIds + EstimatedProgressPagination) / 2.f;
 
 			OnProgress.Broadcast(GridlyTableRows, EstimatedProgress, FGridlyResult::Success);
@@ -192,6 +180,16 @@ void UGridlyTask_ImportDataTableFromGridly::OnProcessRequestComplete(FHttpReques
 			}
 			else
 			{
+				if (bUseIncrementalImport)
+				{
+					SyncState.Finish();
+					SyncState.Save();
+					SyncState.GetRows(GridlyTableRows);
+
+					UE_LOG(LogGridly, Log, TEXT("View ID %s: %d of %d records changed since the last import"), *SyncState.ViewId,
+						ChangedCount, SyncState.Num());
+				}
+
 				RequestPage(CurrentViewIdIndex + 1, 0);
 			}
 		}
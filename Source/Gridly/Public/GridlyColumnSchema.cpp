@@ -0,0 +1,104 @@
+﻿// Copyright (c) 2021 LocalizeDirect AB
+
+#include "GridlyColumnSchema.h"
+
+#include "GridlyCultureConverter.h"
+#include "GridlyGameSettings.h"
+
+FGridlyColumnSchema::FGridlyColumnSchema()
+{
+	const UGridlyGameSettings* GameSettings = GetMutableDefault<UGridlyGameSettings>();
+
+	TargetCultures = FGridlyCultureConverter::GetTargetCultures();
+	NamespaceColumnId = GameSettings->NamespaceColumnId;
+	SourceLanguageColumnIdPrefix = GameSettings->SourceLanguageColumnIdPrefix;
+	TargetLanguageColumnIdPrefix = GameSettings->TargetLanguageColumnIdPrefix;
+	bUseCombinedNamespaceKey = GameSettings->bUseCombinedNamespaceId;
+	bMakeUniqueRecordId = GameSettings->bMakeUniqueRecordId;
+	bUsePathAsNamespace = !bUseCombinedNamespaceKey && NamespaceColumnId == "path";
+}
+
+const FGridlyColumnDescriptor& FGridlyColumnSchema::Resolve(const FString& ColumnId)
+{
+	if (const FGridlyColumnDescriptor* ColumnDescriptor = Columns.Find(ColumnId))
+	{
+		return *ColumnDescriptor;
+	}
+
+	return Columns.Add(ColumnId, ResolveColumn(ColumnId));
+}
+
+bool FGridlyColumnSchema::GetColumnIds(const TArray<FString>& Cultures, TArray<FString>& OutColumnIds) const
+{
+	OutColumnIds.Reset();
+
+	if (!bUsePathAsNamespace && !NamespaceColumnId.IsEmpty())
+	{
+		OutColumnIds.Add(NamespaceColumnId);
+	}
+
+	FString GridlyCulture;
+
+	// The source column of a view may be in any of the target cultures, not only the native one, so all of them are requested
+	TArray<FString> SourceCultures = FGridlyCultureConverter::GetNativeCultures();
+	for (const FString& TargetCulture : TargetCultures)
+	{
+		SourceCultures.AddUnique(TargetCulture);
+	}
+
+	for (const FString& SourceCulture : SourceCultures)
+	{
+		if (!FGridlyCultureConverter::ConvertToGridly(SourceCulture, GridlyCulture))
+		{
+			return false;
+		}
+
+		OutColumnIds.AddUnique(SourceLanguageColumnIdPrefix + GridlyCulture);
+	}
+
+	for (const FString& Culture : Cultures.Num() > 0 ? Cultures : TargetCultures)
+	{
+		if (!FGridlyCultureConverter::ConvertToGridly(Culture, GridlyCulture))
+		{
+			return false;
+		}
+
+		OutColumnIds.AddUnique(TargetLanguageColumnIdPrefix + GridlyCulture);
+	}
+
+	return OutColumnIds.Num() > 0;
+}
+
+FGridlyColumnDescriptor FGridlyColumnSchema::ResolveColumn(const FString& ColumnId) const
+{
+	FGridlyColumnDescriptor ColumnDescriptor;
+
+	// If special columns
+
+	if (!bUsePathAsNamespace && ColumnId == NamespaceColumnId)
+	{
+		ColumnDescriptor.Role = EGridlyColumnRole::Namespace;
+		return ColumnDescriptor;
+	}
+
+	// If language column
+
+	if (ColumnId.StartsWith(SourceLanguageColumnIdPrefix))
+	{
+		const FString GridlyCulture = ColumnId.RightChop(SourceLanguageColumnIdPrefix.Len());
+		if (FGridlyCultureConverter::ConvertFromGridly(TargetCultures, GridlyCulture, ColumnDescriptor.Culture))
+		{
+			ColumnDescriptor.Role = EGridlyColumnRole::Source;
+		}
+	}
+	else if (ColumnId.StartsWith(TargetLanguageColumnIdPrefix))
+	{
+		const FString GridlyCulture = ColumnId.RightChop(TargetLanguageColumnIdPrefix.Len());
+		if (FGridlyCultureConverter::ConvertFromGridly(TargetCultures, GridlyCulture, ColumnDescriptor.Culture))
+		{
+			ColumnDescriptor.Role = EGridlyColumnRole::Target;
+		}
+	}
+
+	return ColumnDescriptor;
+}
@@ -0,0 +1,57 @@
+﻿// Copyright (c) 2021 LocalizeDirect AB
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+enum class EGridlyColumnRole : uint8
+{
+	Ignored,
+	Namespace,
+	Source,
+	Target
+};
+
+struct GRIDLY_API FGridlyColumnDescriptor
+{
+	EGridlyColumnRole Role = EGridlyColumnRole::Ignored;
+
+	/** The resolved culture of source and target language columns */
+	FString Culture;
+};
+
+/**
+ * Resolves what each column of an import holds. The settings and target cultures are captured once on construction, and
+ * every distinct column id is only resolved the first time it is seen.
+ */
+class GRIDLY_API FGridlyColumnSchema
+{
+public:
+	FGridlyColumnSchema();
+
+	const FGridlyColumnDescriptor& Resolve(const FString& ColumnId);
+
+	/**
+	 * The columns an import of the given target cultures reads: the namespace column, the source columns of the native and all
+	 * target cultures, since a view's source column may be in any of them, and the target columns. Uses every target culture
+	 * when Cultures is empty. Returns false if a culture has no Gridly column name, in which case every column has to be downloaded
+	 */
+	bool GetColumnIds(const TArray<FString>& Cultures, TArray<FString>& OutColumnIds) const;
+
+	bool UsePathAsNamespace() const { return bUsePathAsNamespace; }
+	bool UseCombinedNamespaceKey() const { return bUseCombinedNamespaceKey; }
+	bool MakeUniqueRecordId() const { return bMakeUniqueRecordId; }
+
+private:
+	FGridlyColumnDescriptor ResolveColumn(const FString& ColumnId) const;
+
+	TArray<FString> TargetCultures;
+	FString NamespaceColumnId;
+	FString SourceLanguageColumnIdPrefix;
+	FString TargetLanguageColumnIdPrefix;
+	bool bUsePathAsNamespace;
+	bool bUseCombinedNamespaceKey;
+	bool bMakeUniqueRecordId;
+
+	TMap<FString, FGridlyColumnDescriptor> Columns;
+};
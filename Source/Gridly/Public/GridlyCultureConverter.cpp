@@ -12,6 +12,64 @@
 
 #include "Internationalization/Regex.h"
 #include "Kismet/KismetInternationalizationLibrary.h"
+#include "Misc/ScopeLock.h"
+
+namespace GridlyCultureConverter
+{
+// Lookups in both directions of the custom culture mapping, plus memoized fallback results. Built on first use and reset
+// whenever the settings change, while the settings keep editing the mapping itself
+struct FCultureIndex
+{
+	TMap<FString, FString> CultureToGridly;
+	TMap<FString, FString> GridlyToCulture;
+
+	// Gridly culture to "en-US" style culture, empty if the name does not follow the pattern
+	TMap<FString, FString> RegexCultures;
+
+	// The available cultures the suitable cultures were found for, the hash is only a quick check before comparing them
+	uint32 SuitableCulturesHash = 0;
+	TArray<FString> SuitableCulturesAvailable;
+	TMap<FString, FString> SuitableCultures;
+};
+
+FCriticalSection CultureIndexCriticalSection;
+TOptional<FCultureIndex> CultureIndex;
+
+FCultureIndex& GetCultureIndex()
+{
+	if (!CultureIndex.IsSet())
+	{
+		CultureIndex.Emplace();
+
+		const UGridlyGameSettings* GameSettings = GetMutableDefault<UGridlyGameSettings>();
+		if (GameSettings->bUseCustomCultureMapping)
+		{
+			for (const TPair<FString, FString>& Pair : GameSettings->CustomCultureMapping)
+			{
+				CultureIndex->CultureToGridly.Add(Pair.Key, Pair.Value);
+
+				// Keep the first match, like TMap::FindKey does
+				if (!CultureIndex->GridlyToCulture.Contains(Pair.Value))
+				{
+					CultureIndex->GridlyToCulture.Add(Pair.Value, Pair.Key);
+				}
+			}
+		}
+	}
+
+	return CultureIndex.GetValue();
+}
+
+uint32 GetCulturesHash(const TArray<FString>& Cultures)
+{
+	uint32 Hash = GetTypeHash(Cultures.Num());
+	for (const FString& Culture : Cultures)
+	{
+		Hash = HashCombine(Hash, GetTypeHash(Culture));
+	}
+	return Hash;
+}
+}
 
 TArray<FString> FGridlyCultureConverter::GetTargetCultures()
 {
@@ -51,35 +109,82 @@ TArray<FString> FGridlyCultureConverter::GetTargetCultures()
 	return TargetCultures;
 }
 
+TArray<FString> FGridlyCultureConverter::GetNativeCultures()
+{
+	TArray<FString> NativeCultures;
+
+#if WITH_EDITOR
+	for (const ULocalizationTarget* LocalizationTarget : ULocalizationSettings::GetGameTargetSet()->TargetObjects)
+	{
+		const FLocalizationTargetSettings& Settings = LocalizationTarget->Settings;
+		if (Settings.SupportedCulturesStatistics.IsValidIndex(Settings.NativeCultureIndex))
+		{
+			NativeCultures.AddUnique(Settings.SupportedCulturesStatistics[Settings.NativeCultureIndex].CultureName);
+		}
+	}
+#else
+	const FString NativeCulture = FTextLocalizationManager::Get().GetNativeCultureName(ELocalizedTextSourceCategory::Game);
+	if (!NativeCulture.IsEmpty())
+	{
+		NativeCultures.Add(NativeCulture);
+	}
+#endif
+
+	return NativeCultures;
+}
+
 bool FGridlyCultureConverter::ConvertFromGridly(
 	const TArray<FString>& AvailableCultures, const FString& GridlyCulture, FString& OutCulture)
 {
 	if (GridlyCulture.Len() > 0)
 	{
-		// Use custom mapping if it is available
+		FScopeLock Lock(&GridlyCultureConverter::CultureIndexCriticalSection);
+		GridlyCultureConverter::FCultureIndex& CultureIndex = GridlyCultureConverter::GetCultureIndex();
 
-		UGridlyGameSettings* GameSettings = GetMutableDefault<UGridlyGameSettings>();
+		// Use custom mapping if it is available
 
-		if (GameSettings->bUseCustomCultureMapping)
+		if (const FString* CustomCulture = CultureIndex.GridlyToCulture.Find(GridlyCulture))
 		{
-			const FString* CustomCulture = GameSettings->CustomCultureMapping.FindKey(GridlyCulture);
+			OutCulture = *CustomCulture;
+			return true;
+		}
+
+		// Otherwise follow rules of "enUS" -> "en-US"
 
-			if (CustomCulture != nullptr)
+		const FString* Culture = CultureIndex.RegexCultures.Find(GridlyCulture);
+		if (!Culture)
+		{
+			FString NewCulture;
+			const FRegexPattern RegexPattern("([a-z]+)([A-Z]+)");
+			FRegexMatcher RegexMatcher(RegexPattern, GridlyCulture);
+			if (RegexMatcher.FindNext())
 			{
-				OutCulture = *CustomCulture;
-				return true;
+				NewCulture = RegexMatcher.GetCaptureGroup(1) + "-" + RegexMatcher.GetCaptureGroup(2);
 			}
+			Culture = &CultureIndex.RegexCultures.Add(GridlyCulture, NewCulture);
 		}
 
-		// Otherwise follow rules of "enUS" -> "en-US"
-		
-		FString Culture = GridlyCulture;
-		const FRegexPattern RegexPattern("([a-z]+)([A-Z]+)");
-		FRegexMatcher RegexMatcher(RegexPattern, GridlyCulture);
-		if (RegexMatcher.FindNext())
+		if (Culture->Len() > 0)
 		{
-			Culture = RegexMatcher.GetCaptureGroup(1) + "-" + RegexMatcher.GetCaptureGroup(2);
-			OutCulture = UKismetInternationalizationLibrary::GetSuitableCulture(AvailableCultures, Culture, TEXT(""));
+			// The suitable culture depends on the available cultures, which rarely change between calls
+
+			const uint32 AvailableCulturesHash = GridlyCultureConverter::GetCulturesHash(AvailableCultures);
+			if (CultureIndex.SuitableCulturesHash != AvailableCulturesHash
+			    || CultureIndex.SuitableCulturesAvailable != AvailableCultures)
+			{
+				CultureIndex.SuitableCultures.Reset();
+				CultureIndex.SuitableCulturesHash = AvailableCulturesHash;
+				CultureIndex.SuitableCulturesAvailable = AvailableCultures;
+			}
+
+			const FString* SuitableCulture = CultureIndex.SuitableCultures.Find(*Culture);
+			if (!SuitableCulture)
+			{
+				SuitableCulture = &CultureIndex.SuitableCultures.Add(*Culture,
+					UKismetInternationalizationLibrary::GetSuitableCulture(AvailableCultures, *Culture, TEXT("")));
+			}
+
+			OutCulture = *SuitableCulture;
 			return true;
 		}
 	}
@@ -93,13 +198,9 @@ bool FGridlyCultureConverter::ConvertToGridly(const FString& Culture, FString& O
 	{
 		// Use custom mapping if it is available
 
-		UGridlyGameSettings* GameSettings = GetMutableDefault<UGridlyGameSettings>();
-
-		if (GameSettings->bUseCustomCultureMapping)
 		{
-			const FString* CustomCulture = GameSettings->CustomCultureMapping.Find(Culture);
-
-			if (CustomCulture != nullptr)
+			FScopeLock Lock(&GridlyCultureConverter::CultureIndexCriticalSection);
+			if (const FString* CustomCulture = GridlyCultureConverter::GetCultureIndex().CultureToGridly.Find(Culture))
 			{
 				OutGridlyCulture = *CustomCulture;
 				return true;
@@ -118,3 +219,9 @@ bool FGridlyCultureConverter::ConvertToGridly(const FString& Culture, FString& O
 
 	return false;
 }
+
+void FGridlyCultureConverter::InvalidateCache()
+{
+	FScopeLock Lock(&GridlyCultureConverter::CultureIndexCriticalSection);
+	GridlyCultureConverter::CultureIndex.Reset();
+}
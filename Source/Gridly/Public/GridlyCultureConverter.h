@@ -8,7 +8,11 @@ class GRIDLY_API FGridlyCultureConverter
 {
 public:
 	static TArray<FString> GetTargetCultures();
+	static TArray<FString> GetNativeCultures();
 	static bool ConvertFromGridly(const TArray<FString>& AvailableCultures, const FString& GridlyCulture,
 		FString& OutCulture);
 	static bool ConvertToGridly(const FString& Culture, FString& OutGridlyCulture);
+
+	/** Must be called when the culture mapping settings change */
+	static void InvalidateCache();
 };
@@ -1,3 +1,58 @@
 ﻿// Copyright (c) 2021 LocalizeDirect AB
 
 #include "GridlyDataTable.h"
+
+void UGridlyDataTable::FinishDestroy()
+{
+	Super::FinishDestroy();
+
+	ReleaseRecycledRows();
+}
+
+void UGridlyDataTable::RecycleRows()
+{
+	if (!RowStruct)
+	{
+		EmptyTable();
+		return;
+	}
+
+	const int32 RowSize = RowStruct->GetStructureSize();
+	if (RowSize != RecycledRowSize)
+	{
+		ReleaseRecycledRows();
+		RecycledRowSize = RowSize;
+	}
+
+	RecycledRows.Reserve(RecycledRows.Num() + RowMap.Num());
+	for (const TPair<FName, uint8*>& Row : RowMap)
+	{
+		RowStruct->DestroyStruct(Row.Value);
+		RecycledRows.Add(Row.Value);
+	}
+
+	// Keeps the capacity of the map as well, for the rows that are added next
+	RowMap.Reset();
+}
+
+void UGridlyDataTable::ReleaseRecycledRows()
+{
+	for (uint8* RowData : RecycledRows)
+	{
+		FMemory::Free(RowData);
+	}
+
+	RecycledRows.Empty();
+}
+
+uint8* UGridlyDataTable::AllocateRow()
+{
+	check(RowStruct);
+
+	if (RecycledRows.Num() > 0 && RecycledRowSize == RowStruct->GetStructureSize())
+	{
+		return RecycledRows.Pop(false);
+	}
+
+	return (uint8*) FMemory::Malloc(RowStruct->GetStructureSize());
+}
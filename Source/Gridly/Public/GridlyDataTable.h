@@ -10,6 +10,9 @@
 
 /**
  * Data table that can sync with Gridly
+ *
+ * Every row is its own allocation, as UDataTable expects. A re-import recycles the memory of the rows it replaces rather than
+ * freeing and allocating every row again.
  */
 UCLASS(BlueprintType, HideCategories = Object)
 class GRIDLY_API UGridlyDataTable : public UDataTable
@@ -18,7 +21,23 @@ class GRIDLY_API UGridlyDataTable : public UDataTable
 	
 	GENERATED_BODY()
 
+public:
+	virtual void FinishDestroy() override;
+
+	/** Empties the table, keeping the memory of its rows for the rows that are added next */
+	void RecycleRows();
+
+	/** Frees the recycled row memory that was not used again */
+	void ReleaseRecycledRows();
+
 public:
 	UPROPERTY(Category = Gridly, EditDefaultsOnly)
 	FString ViewId;
+
+private:
+	/** Uninitialized memory for a row of the current row struct, allocated with FMemory::Malloc like any other row */
+	uint8* AllocateRow();
+
+	TArray<uint8*> RecycledRows;
+	int32 RecycledRowSize = 0;
 };
@@ -3,10 +3,17 @@
 #include "GridlyDataTableImporterJSON.h"
 
 #include "Runtime/Launch/Resources/Version.h"
+#include "Algo/StableSort.h"
+#include "Async/ParallelFor.h"
+#include "Gridly.h"
 #include "GridlyDataTable.h"
+#include "Dom/JsonValue.h"
 
 namespace GridlyDataTableJSONUtils
 {
+// Rows decoded by one task, enough work to outweigh the scheduling
+constexpr int32 RowsPerDecodeTask = 256;
+
 const TCHAR* JSONTypeToString(const EJson InType)
 {
 	switch (InType)
@@ -43,12 +50,63 @@ FString GetKeyFieldName(const UDataTable& InDataTable)
 		return ExplicitString;
 	}
 }
+
+const FString* FindCellValue(const FGridlyTableRow& InTableRow, const FString& InColumnId)
+{
+	const FGridlyTableCell* Cell = InTableRow.Cells.FindByPredicate([&InColumnId](const FGridlyTableCell& InCell)
+	{
+		return InCell.ColumnId == InColumnId;
+	});
+
+	return Cell ? &Cell->Value : nullptr;
+}
+
+void GetImportColumnIds(const UDataTable& InDataTable, TArray<FString>& OutColumnIds)
+{
+	OutColumnIds.Reset();
+
+	if (!InDataTable.RowStruct)
+	{
+		return;
+	}
+
+	if (!InDataTable.ImportKeyField.IsEmpty())
+	{
+		OutColumnIds.Add(InDataTable.ImportKeyField);
+	}
+
+	TArray<FString> TempPropertyImportNames;
+	for (TFieldIterator<FProperty> It(InDataTable.RowStruct); It; ++It)
+	{
+#if ENGINE_MINOR_VERSION >= 26
+		DataTableUtils::GetPropertyImportNames(*It, TempPropertyImportNames);
+#else
+		TempPropertyImportNames = DataTableUtils::GetPropertyImportNames(*It);
+#endif
+		for (const FString& PropertyImportName : TempPropertyImportNames)
+		{
+			OutColumnIds.AddUnique(PropertyImportName);
+		}
+	}
+}
 }
 
 FGridlyDataTableImporterJSON::FGridlyDataTableImporterJSON(UDataTable& InDataTable, const FString& InJSONData, TArray<FString>& OutProblems) :
 	DataTable(&InDataTable),
-	JSONData(InJSONData),
-	ImportProblems(OutProblems)
+	JSONData(&InJSONData),
+	TableRows(nullptr),
+	ImportProblems(OutProblems),
+	bPatchRows(false)
+{
+}
+
+FGridlyDataTableImporterJSON::FGridlyDataTableImporterJSON(UDataTable& InDataTable, const TArray<FGridlyTableRow>& InTableRows,
+	TArray<FString>& OutProblems, bool bInPatchRows) :
+	DataTable(&InDataTable),
+	JSONData(nullptr),
+	TableRows(&InTableRows),
+	ImportProblems(OutProblems),
+	bPatchRows(bInPatchRows)
 {
 }
 
@@ -58,7 +116,12 @@ FGridlyDataTableImporterJSON::~FGridlyDataTableImporterJSON()
 
 bool FGridlyDataTableImporterJSON::ReadTable()
 {
-	if (JSONData.IsEmpty())
+	if (TableRows)
+	{
+		return ReadTableRows();
+	}
+
+	if (JSONData->IsEmpty())
 	{
 		ImportProblems.Add(TEXT("Input data is empty."));
 		return false;
@@ -73,7 +136,7 @@ bool FGridlyDataTableImporterJSON::ReadTable()
 
 	TArray<TSharedPtr<FJsonValue>> ParsedTableRows;
 	{
-		const TSharedRef<TJsonReader<TCHAR>> JsonReader = TJsonReaderFactory<TCHAR>::Create(JSONData);
+		const TSharedRef<TJsonReader<TCHAR>> JsonReader = TJsonReaderFactory<TCHAR>::Create(*JSONData);
 		if (!FJsonSerializer::Deserialize(JsonReader, ParsedTableRows) || ParsedTableRows.Num() == 0)
 		{
 			ImportProblems.Add(FString::Printf(TEXT("Failed to parse the JSON data. Error: %s"), *JsonReader->GetErrorMessage()));
@@ -81,8 +144,9 @@ bool FGridlyDataTableImporterJSON::ReadTable()
 		}
 	}
 
-	// Empty existing data
-	DataTable->EmptyTable();
+	// Empty existing data, the memory of its rows is used again for the new ones
+	UGridlyDataTable* GridlyDataTable = Cast<UGridlyDataTable>(DataTable);
+	GridlyDataTable->RecycleRows();
 
 	// Iterate over rows
 	for (int32 RowIdx = 0; RowIdx < ParsedTableRows.Num(); ++RowIdx)
@@ -98,11 +162,512 @@ bool FGridlyDataTableImporterJSON::ReadTable()
 		ReadRow(ParsedTableRowObject.ToSharedRef(), RowIdx);
 	}
 
+	GridlyDataTable->ReleaseRecycledRows();
+
+	DataTable->Modify(true);
+
+	return true;
+}
+
+bool FGridlyDataTableImporterJSON::ReadTableRows()
+{
+	// When patching, no records means every record was deleted in Gridly, so every row is removed
+	if (TableRows->Num() == 0 && !bPatchRows)
+	{
+		ImportProblems.Add(TEXT("Input data is empty."));
+		return false;
+	}
+
+	// Check we have a RowStruct specified
+	if (!DataTable->RowStruct)
+	{
+		ImportProblems.Add(TEXT("No RowStruct specified."));
+		return false;
+	}
+
+	if (bPatchRows)
+	{
+		return PatchTableRows();
+	}
+
+	// Empty existing data, the memory of its rows is used again for the new ones
+	UGridlyDataTable* GridlyDataTable = Cast<UGridlyDataTable>(DataTable);
+	GridlyDataTable->RecycleRows();
+
+	// Rows are added to the table first, and filled in afterwards
+	TArray<FDecodeRow> DecodeRows;
+	DecodeRows.Reserve(TableRows->Num());
+
+	for (int32 RowIdx = 0; RowIdx < TableRows->Num(); ++RowIdx)
+	{
+		const FGridlyTableRow& TableRow = (*TableRows)[RowIdx];
+
+		FName RowName;
+		if (!GetTableRowName(TableRow, RowIdx, RowName))
+		{
+			continue;
+		}
+
+		// Check its not a duplicate
+		if (!DataTable->AllowDuplicateRowsOnImport() && DataTable->GetRowMap().Find(RowName) != nullptr)
+		{
+			ImportProblems.Add(FString::Printf(TEXT("Duplicate row name '%s'."), *RowName.ToString()));
+			continue;
+		}
+
+		// Allocate data to store information, recycled from the rows the table held before
+		uint8* RowData = GridlyDataTable->AllocateRow();
+		DataTable->RowStruct->InitializeStruct(RowData);
+		// And be sure to call DestroyScriptStruct later
+
+		// Add to row map
+		GridlyDataTable->AddRowInternal(RowName, RowData);
+
+		DecodeRows.Add(FDecodeRow{&TableRow, RowName, RowData});
+	}
+
+	DecodeTableRows(DecodeRows);
+	GridlyDataTable->ReleaseRecycledRows();
+
 	DataTable->Modify(true);
 
 	return true;
 }
 
+bool FGridlyDataTableImporterJSON::PatchTableRows()
+{
+	UScriptStruct* RowStruct = DataTable->RowStruct;
+	UGridlyDataTable* GridlyDataTable = Cast<UGridlyDataTable>(DataTable);
+
+	// New rows are added and decoded in place. Rows that already exist are decoded into scratch memory first, and only written
+	// to the table if they differ from the row already there
+	TArray<FDecodeRow> DecodeRows;
+	TArray<uint8*> ExistingRows;
+	DecodeRows.Reserve(TableRows->Num());
+	ExistingRows.Reserve(TableRows->Num());
+
+	TSet<FName> ImportedRowNames;
+	ImportedRowNames.Reserve(TableRows->Num());
+
+	int32 NumAddedRows = 0;
+	int32 NumChangedRows = 0;
+	SIZE_T NumScratchRows = 0;
+
+	for (int32 RowIdx = 0; RowIdx < TableRows->Num(); ++RowIdx)
+	{
+		const FGridlyTableRow& TableRow = (*TableRows)[RowIdx];
+
+		FName RowName;
+		if (!GetTableRowName(TableRow, RowIdx, RowName))
+		{
+			continue;
+		}
+
+		// Check its not a duplicate
+		bool bAlreadyImported = false;
+		ImportedRowNames.Add(RowName, &bAlreadyImported);
+		if (bAlreadyImported && !DataTable->AllowDuplicateRowsOnImport())
+		{
+			ImportProblems.Add(FString::Printf(TEXT("Duplicate row name '%s'."), *RowName.ToString()));
+			continue;
+		}
+
+		if (uint8* const* ExistingRowData = DataTable->GetRowMap().Find(RowName))
+		{
+			DecodeRows.Add(FDecodeRow{&TableRow, RowName, nullptr});
+			ExistingRows.Add(*ExistingRowData);
+			NumScratchRows++;
+		}
+		else
+		{
+			// Allocated the regular way, like rows the table held before
+			uint8* RowData = GridlyDataTable->AllocateRow();
+			RowStruct->InitializeStruct(RowData);
+			GridlyDataTable->AddRowInternal(RowName, RowData);
+
+			DecodeRows.Add(FDecodeRow{&TableRow, RowName, RowData});
+			ExistingRows.Add(nullptr);
+			NumAddedRows++;
+		}
+	}
+
+	const SIZE_T RowStride = RowStruct->GetStructureSize();
+	uint8* ScratchRowsData = (uint8*) FMemory::Malloc(NumScratchRows * RowStride, RowStruct->GetMinAlignment());
+
+	SIZE_T ScratchRowIndex = 0;
+	for (int32 DecodeRowIndex = 0; DecodeRowIndex < DecodeRows.Num(); ++DecodeRowIndex)
+	{
+		if (ExistingRows[DecodeRowIndex])
+		{
+			DecodeRows[DecodeRowIndex].RowData = ScratchRowsData + ScratchRowIndex++ * RowStride;
+			RowStruct->InitializeStruct(DecodeRows[DecodeRowIndex].RowData);
+		}
+	}
+
+	DecodeTableRows(DecodeRows);
+
+	for (int32 DecodeRowIndex = 0; DecodeRowIndex < DecodeRows.Num(); ++DecodeRowIndex)
+	{
+		uint8* ExistingRowData = ExistingRows[DecodeRowIndex];
+		if (!ExistingRowData)
+		{
+			continue;
+		}
+
+		const FDecodeRow& DecodeRow = DecodeRows[DecodeRowIndex];
+		if (!RowStruct->CompareScriptStruct(ExistingRowData, DecodeRow.RowData, PPF_None))
+		{
+			RowStruct->CopyScriptStruct(ExistingRowData, DecodeRow.RowData);
+			NumChangedRows++;
+		}
+
+		RowStruct->DestroyStruct(DecodeRow.RowData);
+	}
+
+	FMemory::Free(ScratchRowsData);
+
+	// Rows that are no longer in Gridly
+
+	TArray<FName> RemovedRowNames;
+	for (const TPair<FName, uint8*>& Row : DataTable->GetRowMap())
+	{
+		if (!ImportedRowNames.Contains(Row.Key))
+		{
+			RemovedRowNames.Add(Row.Key);
+		}
+	}
+
+	for (const FName& RemovedRowName : RemovedRowNames)
+	{
+		GridlyDataTable->RemoveRowInternal(RemovedRowName);
+	}
+
+	UE_LOG(LogGridly, Log, TEXT("Patched data table %s: %d rows added, %d changed, %d removed"), *DataTable->GetName(),
+		NumAddedRows, NumChangedRows, RemovedRowNames.Num());
+
+	// An unchanged table is left clean, and listeners are told about all changes at once
+
+	if (NumAddedRows > 0 || NumChangedRows > 0 || RemovedRowNames.Num() > 0)
+	{
+		DataTable->Modify(true);
+		DataTable->OnDataTableChanged().Broadcast();
+	}
+
+	return true;
+}
+
+const FGridlyDataTableImporterJSON::FImportPlan& FGridlyDataTableImporterJSON::GetImportPlan(const UScriptStruct* InStruct)
+{
+	if (const TUniquePtr<FImportPlan>* ExistingImportPlan = ImportPlans.Find(InStruct))
+	{
+		return **ExistingImportPlan;
+	}
+
+#if WITH_EDITOR
+	// If the structure has specified the property as optional for import (gameplay code likely doing a custom fix-up or parse of that property),
+	// then avoid warning about it
+	static const FName DataTableImportOptionalMetadataKey(TEXT("DataTableImportOptional"));
+#endif // WITH_EDITOR
+
+	TUniquePtr<FImportPlan> ImportPlan = MakeUnique<FImportPlan>();
+
+	TArray<FString> TempPropertyImportNames;
+	for (TFieldIterator<FProperty> It(InStruct); It; ++It)
+	{
+		FProperty* BaseProp = *It;
+		check(BaseProp);
+
+		const int32 PropertyIndex = ImportPlan->Properties.AddDefaulted();
+		FImportPlanProperty& PlanProperty = ImportPlan->Properties[PropertyIndex];
+		PlanProperty.Property = BaseProp;
+		PlanProperty.ColumnName = DataTableUtils::GetPropertyExportName(BaseProp);
+#if WITH_EDITOR
+		PlanProperty.bOptional = BaseProp->HasMetaData(DataTableImportOptionalMetadataKey);
+#else
+		PlanProperty.bOptional = false;
+#endif // WITH_EDITOR
+
+		FNumericProperty* NumProp = CastField<FNumericProperty>(BaseProp);
+		if (BaseProp->IsA<FEnumProperty>() || (NumProp && NumProp->IsEnum()))
+		{
+			PlanProperty.Converter = EImportConverter::Enum;
+		}
+		else if (NumProp)
+		{
+			PlanProperty.Converter = NumProp->IsInteger() ? EImportConverter::Integer : EImportConverter::Double;
+		}
+		else if (BaseProp->IsA<FBoolProperty>())
+		{
+			PlanProperty.Converter = EImportConverter::Bool;
+		}
+		else if (BaseProp->IsA<FArrayProperty>() || BaseProp->IsA<FSetProperty>() || BaseProp->IsA<FMapProperty>()
+		         || BaseProp->IsA<FStructProperty>())
+		{
+			PlanProperty.Converter = EImportConverter::Json;
+		}
+		else
+		{
+			PlanProperty.Converter = EImportConverter::String;
+		}
+
+		// Object references may find or load objects, and texts may load string tables, so those stay on the calling thread
+		if (PlanProperty.Converter == EImportConverter::String)
+		{
+			PlanProperty.bThreadSafe = BaseProp->IsA<FStrProperty>() || BaseProp->IsA<FNameProperty>();
+		}
+		else
+		{
+			PlanProperty.bThreadSafe = PlanProperty.Converter != EImportConverter::Json;
+		}
+
+		// Column names are case insensitive, like JSON fields. Should two properties accept the same name, the first keeps it
+#if ENGINE_MINOR_VERSION >= 26
+		DataTableUtils::GetPropertyImportNames(BaseProp, TempPropertyImportNames);
+#else
+		TempPropertyImportNames = DataTableUtils::GetPropertyImportNames(BaseProp);
+#endif
+		for (int32 NameIndex = 0; NameIndex < TempPropertyImportNames.Num(); ++NameIndex)
+		{
+			if (!ImportPlan->Columns.Contains(TempPropertyImportNames[NameIndex]))
+			{
+				ImportPlan->Columns.Add(TempPropertyImportNames[NameIndex], FImportPlanColumn{PropertyIndex, NameIndex});
+			}
+		}
+
+		// The property name itself is never reported as an extra field
+		const FString PropertyName = BaseProp->GetName();
+		if (!ImportPlan->Columns.Contains(PropertyName))
+		{
+			ImportPlan->Columns.Add(PropertyName, FImportPlanColumn{PropertyIndex, INDEX_NONE});
+		}
+	}
+
+	return *ImportPlans.Add(InStruct, MoveTemp(ImportPlan));
+}
+
+bool FGridlyDataTableImporterJSON::GetTableRowName(const FGridlyTableRow& InTableRow, const int32 InRowIdx, FName& OutRowName)
+{
+	// Get row name, the record ID unless the table names a column to use instead
+	const FString RowKey = GridlyDataTableJSONUtils::GetKeyFieldName(*DataTable);
+	const FString* RowKeyValue = &InTableRow.Id;
+	if (!DataTable->ImportKeyField.IsEmpty())
+	{
+		RowKeyValue = GridlyDataTableJSONUtils::FindCellValue(InTableRow, RowKey);
+	}
+
+	OutRowName = RowKeyValue ? DataTableUtils::MakeValidName(*RowKeyValue) : NAME_None;
+
+	// Check its not 'none'
+	if (OutRowName.IsNone())
+	{
+		ImportProblems.Add(FString::Printf(TEXT("Row '%d' missing key field '%s'."), InRowIdx, *RowKey));
+		return false;
+	}
+
+	return true;
+}
+
+void FGridlyDataTableImporterJSON::DecodeTableRows(const TArray<FDecodeRow>& InRows)
+{
+	// Built up front, the decode tasks only read from it
+	const FImportPlan& ImportPlan = GetImportPlan(DataTable->RowStruct);
+	const FString RowKey = GridlyDataTableJSONUtils::GetKeyFieldName(*DataTable);
+
+	// Rows are decoded concurrently, a range of rows per task. Each task only writes to its own rows and lists, which are merged
+	// in row order afterwards so the problems reported do not depend on scheduling
+
+	TArray<FDecodeTask> DecodeTasks;
+	DecodeTasks.SetNum(FMath::DivideAndRoundUp(InRows.Num(), GridlyDataTableJSONUtils::RowsPerDecodeTask));
+
+	ParallelFor(DecodeTasks.Num(), [this, &InRows, &ImportPlan, &RowKey, &DecodeTasks](int32 TaskIndex)
+	{
+		const int32 FirstRowIndex = TaskIndex * GridlyDataTableJSONUtils::RowsPerDecodeTask;
+		const int32 EndRowIndex = FMath::Min(FirstRowIndex + GridlyDataTableJSONUtils::RowsPerDecodeTask, InRows.Num());
+		for (int32 DecodeRowIndex = FirstRowIndex; DecodeRowIndex < EndRowIndex; ++DecodeRowIndex)
+		{
+			DecodeTableRow(InRows, DecodeRowIndex, ImportPlan, RowKey, DecodeTasks[TaskIndex]);
+		}
+	});
+
+	for (FDecodeTask& DecodeTask : DecodeTasks)
+	{
+		for (const FSerialCell& SerialCell : DecodeTask.SerialCells)
+		{
+			// Nested structs report to the importer directly, so whatever the cell added is moved back out to be sorted in
+			const int32 NumImportProblems = ImportProblems.Num();
+
+			const FDecodeRow& Row = InRows[SerialCell.DecodeRowIndex];
+			ReadCell(*SerialCell.Value, Row.RowName, ImportPlan.Properties[SerialCell.PropertyIndex], Row.RowData, ImportProblems);
+
+			for (int32 ProblemIndex = NumImportProblems; ProblemIndex < ImportProblems.Num(); ++ProblemIndex)
+			{
+				DecodeTask.Problems.Add(FDecodeProblem{SerialCell.DecodeRowIndex, SerialCell.PropertyIndex,
+					MoveTemp(ImportProblems[ProblemIndex])});
+			}
+
+			ImportProblems.SetNum(NumImportProblems, false);
+		}
+
+		// Reported in the order a serial import would, by row and then by property
+		Algo::StableSortBy(DecodeTask.Problems, [](const FDecodeProblem& InProblem)
+		{
+			return TPair<int32, int32>(InProblem.DecodeRowIndex, InProblem.PropertyIndex);
+		});
+
+		for (FDecodeProblem& Problem : DecodeTask.Problems)
+		{
+			ImportProblems.Add(MoveTemp(Problem.Message));
+		}
+	}
+}
+
+void FGridlyDataTableImporterJSON::DecodeTableRow(const TArray<FDecodeRow>& InRows, const int32 InDecodeRowIndex,
+	const FImportPlan& InImportPlan, const FString& InRowKey, FDecodeTask& OutDecodeTask)
+{
+	const FDecodeRow& Row = InRows[InDecodeRowIndex];
+	TArray<FString> CellProblems;
+
+	// Match every cell to its property in a single pass
+	TArray<const FString*, TInlineAllocator<64>> PropertyValues;
+	TArray<int32, TInlineAllocator<64>> PropertyValueNameIndices;
+	PropertyValues.SetNumZeroed(InImportPlan.Properties.Num());
+	PropertyValueNameIndices.SetNumZeroed(InImportPlan.Properties.Num());
+
+	for (const FGridlyTableCell& Cell : Row.TableRow->Cells)
+	{
+		const FImportPlanColumn* Column = InImportPlan.Columns.Find(Cell.ColumnId);
+		if (!Column)
+		{
+			// Detect any extra fields within the data for this row, skipping the row name as that doesn't match a property
+			if (!DataTable->bIgnoreExtraFields && Cell.ColumnId != InRowKey)
+			{
+				OutDecodeTask.Problems.Add(FDecodeProblem{InDecodeRowIndex, INDEX_NONE,
+					FString::Printf(TEXT("Property '%s' on row '%s' cannot be found in struct '%s'."),
+						*DataTableUtils::MakeValidName(Cell.ColumnId).ToString(), *Row.RowName.ToString(),
+						*DataTable->RowStruct->GetName())});
+			}
+
+			continue;
+		}
+
+		if (Column->NameIndex != INDEX_NONE
+		    && (!PropertyValues[Column->PropertyIndex] || Column->NameIndex < PropertyValueNameIndices[Column->PropertyIndex]))
+		{
+			PropertyValues[Column->PropertyIndex] = &Cell.Value;
+			PropertyValueNameIndices[Column->PropertyIndex] = Column->NameIndex;
+		}
+	}
+
+	// Now read in each property
+	for (int32 PropertyIndex = 0; PropertyIndex < InImportPlan.Properties.Num(); ++PropertyIndex)
+	{
+		const FImportPlanProperty& PlanProperty = InImportPlan.Properties[PropertyIndex];
+
+		const FString* CellValue = PropertyValues[PropertyIndex];
+		if (!CellValue)
+		{
+			if (!PlanProperty.bOptional && !DataTable->bIgnoreMissingFields)
+			{
+				OutDecodeTask.Problems.Add(FDecodeProblem{InDecodeRowIndex, PropertyIndex,
+					FString::Printf(TEXT("Row '%s' is missing an entry for '%s'."), *Row.RowName.ToString(), *PlanProperty.ColumnName)});
+			}
+
+			continue;
+		}
+
+		if (PlanProperty.Property->ArrayDim != 1)
+		{
+			// Cells only ever hold a single string
+			OutDecodeTask.Problems.Add(FDecodeProblem{InDecodeRowIndex, PropertyIndex,
+				FString::Printf(TEXT("Property '%s' on row '%s' is the incorrect type. Expected Array, got String."),
+					*PlanProperty.ColumnName, *Row.RowName.ToString())});
+			return;
+		}
+
+		if (PlanProperty.bThreadSafe)
+		{
+			ReadCell(*CellValue, Row.RowName, PlanProperty, Row.RowData, CellProblems);
+
+			for (FString& CellProblem : CellProblems)
+			{
+				OutDecodeTask.Problems.Add(FDecodeProblem{InDecodeRowIndex, PropertyIndex, MoveTemp(CellProblem)});
+			}
+
+			CellProblems.Reset();
+		}
+		else
+		{
+			OutDecodeTask.SerialCells.Add(FSerialCell{InDecodeRowIndex, PropertyIndex, CellValue});
+		}
+	}
+}
+
+bool FGridlyDataTableImporterJSON::ReadCell(const FString& InValue, const FName InRowName, const FImportPlanProperty& InPlanProperty,
+	void* InRowData, TArray<FString>& OutProblems)
+{
+	// Cells are strings, so scalars are converted the same way the JSON path converts string values, without the JSON value
+
+	FProperty* Property = InPlanProperty.Property;
+	void* PropertyData = Property->ContainerPtrToValuePtr<void>(InRowData, 0);
+
+	switch (InPlanProperty.Converter)
+	{
+		case EImportConverter::Integer:
+		case EImportConverter::Double:
+		{
+			const bool bInteger = InPlanProperty.Converter == EImportConverter::Integer;
+			if (!InValue.IsNumeric())
+			{
+				OutProblems.Add(FString::Printf(TEXT("Property '%s' on row '%s' is the incorrect type. Expected %s, got String."),
+					*InPlanProperty.ColumnName, *InRowName.ToString(), bInteger ? TEXT("Integer") : TEXT("Double")));
+				return false;
+			}
+
+			FNumericProperty* NumProp = CastFieldChecked<FNumericProperty>(Property);
+			const double PropertyValue = FCString::Atod(*InValue);
+			if (bInteger)
+			{
+				NumProp->SetIntPropertyValue(PropertyData, static_cast<int64>(FMath::RoundHalfFromZero(PropertyValue)));
+			}
+			else
+			{
+				NumProp->SetFloatingPointPropertyValue(PropertyData, PropertyValue);
+			}
+
+			return true;
+		}
+		case EImportConverter::Bool:
+			CastFieldChecked<FBoolProperty>(Property)->SetPropertyValue(PropertyData, InValue.ToBool());
+			return true;
+		case EImportConverter::Json:
+			// Containers and structs keep their JSON handling, which reports the type mismatch or parses the struct string. These
+			// are only read on the calling thread, where OutProblems is the list of the importer
+			return ReadStructEntry(MakeShared<FJsonValueString>(InValue), InRowName, InPlanProperty.ColumnName, InRowData, Property,
+				PropertyData);
+		default:
+		{
+			const FString Error = DataTableUtils::AssignStringToProperty(InValue, Property, (uint8*) InRowData);
+			if (Error.Len() > 0)
+			{
+				if (InPlanProperty.Converter == EImportConverter::Enum)
+				{
+					OutProblems.Add(FString::Printf(TEXT("Property '%s' on row '%s' has invalid enum value: %s."),
+						*InPlanProperty.ColumnName, *InRowName.ToString(), *InValue));
+				}
+				else
+				{
+					OutProblems.Add(FString::Printf(TEXT("Problem assigning string '%s' to property '%s' on row '%s' : %s"),
+						*InValue, *InPlanProperty.ColumnName, *InRowName.ToString(), *Error));
+				}
+
+				return false;
+			}
+
+			return true;
+		}
+	}
+}
+
 bool FGridlyDataTableImporterJSON::ReadRow(const TSharedRef<FJsonObject>& InParsedTableRowObject, const int32 InRowIdx)
 {
 	// Get row name
@@ -126,7 +691,7 @@ bool FGridlyDataTableImporterJSON::ReadRow(const TSharedRef<FJsonObject>& InPars
 	// Detect any extra fields within the data for this row
 	if (!DataTable->bIgnoreExtraFields)
 	{
-		TArray<FString> TempPropertyImportNames;
+		const FImportPlan& ImportPlan = GetImportPlan(DataTable->RowStruct);
 		for (const TPair<FString, TSharedPtr<FJsonValue>>& ParsedPropertyKeyValuePair : InParsedTableRowObject->Values)
 		{
 			if (ParsedPropertyKeyValuePair.Key == RowKey)
@@ -135,33 +700,22 @@ bool FGridlyDataTableImporterJSON::ReadRow(const TSharedRef<FJsonObject>& InPars
 				continue;
 			}
 
-			FName PropName = DataTableUtils::MakeValidName(ParsedPropertyKeyValuePair.Key);
-			FProperty* ColumnProp = FindFProperty<FProperty>(DataTable->RowStruct, PropName);
-			for (TFieldIterator<FProperty> It(DataTable->RowStruct); It && !ColumnProp; ++It)
-			{
-#if ENGINE_MINOR_VERSION >= 26
-				DataTableUtils::GetPropertyImportNames(*It, TempPropertyImportNames);
-#else
-				TempPropertyImportNames = DataTableUtils::GetPropertyImportNames(*It);
-#endif
-				ColumnProp = TempPropertyImportNames.Contains(ParsedPropertyKeyValuePair.Key) ? *It : nullptr;
-			}
-
-			if (!ColumnProp)
+			if (!ImportPlan.Columns.Contains(ParsedPropertyKeyValuePair.Key))
 			{
 				ImportProblems.Add(FString::Printf(TEXT("Property '%s' on row '%s' cannot be found in struct '%s'."),
-					*PropName.ToString(), *RowName.ToString(), *DataTable->RowStruct->GetName()));
+					*DataTableUtils::MakeValidName(ParsedPropertyKeyValuePair.Key).ToString(), *RowName.ToString(),
+					*DataTable->RowStruct->GetName()));
 			}
 		}
 	}
 
-	// Allocate data to store information, using UScriptStruct to know its size
-	uint8* RowData = (uint8*) FMemory::Malloc(DataTable->RowStruct->GetStructureSize());
+	// Allocate data to store information, recycled from the rows the table held before
+	UGridlyDataTable* GridlyDataTable = Cast<UGridlyDataTable>(DataTable);
+	uint8* RowData = GridlyDataTable->AllocateRow();
 	DataTable->RowStruct->InitializeStruct(RowData);
 	// And be sure to call DestroyScriptStruct later
 
 	// Add to row map
-	UGridlyDataTable* GridlyDataTable = Cast<UGridlyDataTable>(DataTable);
 	GridlyDataTable->AddRowInternal(RowName, RowData);
 
 	return ReadStruct(InParsedTableRowObject, DataTable->RowStruct, RowName, RowData);
@@ -170,43 +724,35 @@ bool FGridlyDataTableImporterJSON::ReadRow(const TSharedRef<FJsonObject>& InPars
 bool FGridlyDataTableImporterJSON::ReadStruct(const TSharedRef<FJsonObject>& InParsedObject, UScriptStruct* InStruct,
 	const FName InRowName, void* InStructData)
 {
-	// Now read in each property
-	TArray<FString> TempPropertyImportNames;
-	for (TFieldIterator<FProperty> It(InStruct); It; ++It)
-	{
-		FProperty* BaseProp = *It;
-		check(BaseProp);
+	const FImportPlan& ImportPlan = GetImportPlan(InStruct);
 
-		const FString ColumnName = DataTableUtils::GetPropertyExportName(BaseProp);
+	// Match every field to its property in a single pass
+	TArray<const TSharedPtr<FJsonValue>*, TInlineAllocator<64>> PropertyValues;
+	TArray<int32, TInlineAllocator<64>> PropertyValueNameIndices;
+	PropertyValues.SetNumZeroed(ImportPlan.Properties.Num());
+	PropertyValueNameIndices.SetNumZeroed(ImportPlan.Properties.Num());
 
-		TSharedPtr<FJsonValue> ParsedPropertyValue;
-#if ENGINE_MINOR_VERSION >= 26
-		DataTableUtils::GetPropertyImportNames(BaseProp, TempPropertyImportNames);
-#else
-		TempPropertyImportNames = DataTableUtils::GetPropertyImportNames(BaseProp);
-#endif
-		for (const FString& PropertyName : TempPropertyImportNames)
+	for (const TPair<FString, TSharedPtr<FJsonValue>>& ParsedPropertyKeyValuePair : InParsedObject->Values)
+	{
+		const FImportPlanColumn* Column = ImportPlan.Columns.Find(ParsedPropertyKeyValuePair.Key);
+		if (Column && Column->NameIndex != INDEX_NONE && ParsedPropertyKeyValuePair.Value.IsValid()
+		    && (!PropertyValues[Column->PropertyIndex] || Column->NameIndex < PropertyValueNameIndices[Column->PropertyIndex]))
 		{
-			ParsedPropertyValue = InParsedObject->TryGetField(PropertyName);
-			if (ParsedPropertyValue.IsValid())
-			{
-				break;
-			}
+			PropertyValues[Column->PropertyIndex] = &ParsedPropertyKeyValuePair.Value;
+			PropertyValueNameIndices[Column->PropertyIndex] = Column->NameIndex;
 		}
+	}
 
-		if (!ParsedPropertyValue.IsValid())
-		{
-#if WITH_EDITOR
-			// If the structure has specified the property as optional for import (gameplay code likely doing a custom fix-up or parse of that property),
-			// then avoid warning about it
-			static const FName DataTableImportOptionalMetadataKey(TEXT("DataTableImportOptional"));
-			if (BaseProp->HasMetaData(DataTableImportOptionalMetadataKey))
-			{
-				continue;
-			}
-#endif // WITH_EDITOR
+	// Now read in each property
+	for (int32 PropertyIndex = 0; PropertyIndex < ImportPlan.Properties.Num(); ++PropertyIndex)
+	{
+		const FImportPlanProperty& PlanProperty = ImportPlan.Properties[PropertyIndex];
+		FProperty* BaseProp = PlanProperty.Property;
+		const FString& ColumnName = PlanProperty.ColumnName;
 
-			if (!DataTable->bIgnoreMissingFields)
+		if (!PropertyValues[PropertyIndex])
+		{
+			if (!PlanProperty.bOptional && !DataTable->bIgnoreMissingFields)
 			{
 				ImportProblems.Add(FString::Printf(TEXT("Row '%s' is missing an entry for '%s'."), *InRowName.ToString(),
 					*ColumnName));
@@ -215,6 +761,8 @@ bool FGridlyDataTableImporterJSON::ReadStruct(const TSharedRef<FJsonObject>& InP
 			continue;
 		}
 
+		const TSharedPtr<FJsonValue>& ParsedPropertyValue = *PropertyValues[PropertyIndex];
+
 		if (BaseProp->ArrayDim == 1)
 		{
 			void* Data = BaseProp->ContainerPtrToValuePtr<void>(InStructData, 0);
@@ -5,21 +5,114 @@
 #include "CoreMinimal.h"
 
 #include "Engine/DataTable.h"
+#include "GridlyTableRow.h"
 
 namespace GridlyDataTableJSONUtils
 {
 	FString GRIDLY_API GetKeyFieldName(const UDataTable& InDataTable);
+
+	/** Every column name the row struct accepts, including the key field when it is set explicitly */
+	void GRIDLY_API GetImportColumnIds(const UDataTable& InDataTable, TArray<FString>& OutColumnIds);
 }
 
 class GRIDLY_API FGridlyDataTableImporterJSON
 {
 public:
 	FGridlyDataTableImporterJSON(UDataTable& InDataTable, const FString& InJSONData, TArray<FString>& OutProblems);
+
+	/**
+	 * Imports downloaded records directly, the record ID is used as row name and each cell as the column of the same name. With
+	 * bInPatchRows, only rows that were added, changed or removed are touched instead of rebuilding the whole table
+	 */
+	FGridlyDataTableImporterJSON(UDataTable& InDataTable, const TArray<FGridlyTableRow>& InTableRows,
+		TArray<FString>& OutProblems, bool bInPatchRows = false);
 	~FGridlyDataTableImporterJSON();
 
 	bool ReadTable();
 
 private:
+	/** How a cell is written into its property */
+	enum class EImportConverter : uint8
+	{
+		Integer,
+		Double,
+		Bool,
+		Enum,
+		String,
+		/** Containers and structs, which keep the JSON value handling */
+		Json
+	};
+
+	struct FImportPlanProperty
+	{
+		FProperty* Property;
+		FString ColumnName;
+		EImportConverter Converter;
+		bool bOptional;
+
+		/** Whether cells can be converted on worker threads */
+		bool bThreadSafe;
+	};
+
+	struct FImportPlanColumn
+	{
+		int32 PropertyIndex;
+
+		/** Position in the import names of the property, the earliest one present wins. INDEX_NONE if only recognized */
+		int32 NameIndex;
+	};
+
+	/** The properties of a struct and every column name they accept, so a row is matched to properties in a single pass */
+	struct FImportPlan
+	{
+		TArray<FImportPlanProperty> Properties;
+		TMap<FString, FImportPlanColumn> Columns;
+	};
+
+	/** A record and the row it is decoded into */
+	struct FDecodeRow
+	{
+		const FGridlyTableRow* TableRow;
+		FName RowName;
+		uint8* RowData;
+	};
+
+	/** A cell left for the calling thread */
+	struct FSerialCell
+	{
+		int32 DecodeRowIndex;
+		int32 PropertyIndex;
+		const FString* Value;
+	};
+
+	/** A problem and where it was found, so problems can be reported in row order whichever thread found them */
+	struct FDecodeProblem
+	{
+		int32 DecodeRowIndex;
+
+		/** INDEX_NONE for problems with the row itself, which come before those of its properties */
+		int32 PropertyIndex;
+
+		FString Message;
+	};
+
+	struct FDecodeTask
+	{
+		TArray<FDecodeProblem> Problems;
+		TArray<FSerialCell> SerialCells;
+	};
+
+	const FImportPlan& GetImportPlan(const UScriptStruct* InStruct);
+
+	bool ReadTableRows();
+	bool PatchTableRows();
+	bool GetTableRowName(const FGridlyTableRow& InTableRow, const int32 InRowIdx, FName& OutRowName);
+	void DecodeTableRows(const TArray<FDecodeRow>& InRows);
+	void DecodeTableRow(const TArray<FDecodeRow>& InRows, const int32 InDecodeRowIndex, const FImportPlan& InImportPlan,
+		const FString& InRowKey, FDecodeTask& OutDecodeTask);
+	bool ReadCell(const FString& InValue, const FName InRowName, const FImportPlanProperty& InPlanProperty, void* InRowData,
+		TArray<FString>& OutProblems);
+
 	bool ReadRow(const TSharedRef<FJsonObject>& InParsedTableRowObject, const int32 InRowIdx);
 	bool ReadStruct(const TSharedRef<FJsonObject>& InParsedObject, UScriptStruct* InStruct, const FName InRowName,
 		void* InStructData);
@@ -29,6 +122,11 @@ private:
 		const int32 InArrayEntryIndex, FProperty* InProperty, void* InPropertyData);
 
 	UDataTable* DataTable;
-	const FString& JSONData;
+	const FString* JSONData;
+	const TArray<FGridlyTableRow>* TableRows;
 	TArray<FString>& ImportProblems;
+	bool bPatchRows;
+
+	// Built on first use, per struct so nested structs get one as well
+	TMap<const UScriptStruct*, TUniquePtr<FImportPlan>> ImportPlans;
 };
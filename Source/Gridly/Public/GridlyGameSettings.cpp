@@ -2,6 +2,8 @@
 
 #include "GridlyGameSettings.h"
 
+#include "GridlyCultureConverter.h"
+
 UGridlyGameSettings::UGridlyGameSettings() :
 	CustomCultureMapping({
 		{"en-US", "enUS"},
@@ -172,10 +174,21 @@ UGridlyGameSettings::UGridlyGameSettings() :
 #endif
 }
 
+#if WITH_EDITOR
+void UGridlyGameSettings::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	FGridlyCultureConverter::InvalidateCache();
+}
+#endif
+
 bool UGridlyGameSettings::OnSettingsSaved()
 {
 	UGridlyGameSettings* GridlyGameSettings = GetMutableDefault<UGridlyGameSettings>();
 
+	FGridlyCultureConverter::InvalidateCache();
+
 #if WITH_EDITOR
 	GConfig->SetString(
 		TEXT("Gridly"),
@@ -25,7 +25,7 @@ public:
 };
 
 UCLASS(BlueprintType, Config = Game, DefaultConfig,
-	AutoExpandCategories=("Gridly|Import Settings", "Gridly|Export Settings", "Gridly|Options"))
+	AutoExpandCategories=("Gridly|Import Settings", "Gridly|Export Settings", "Gridly|Options", "Gridly|Network Settings"))
 class GRIDLY_API UGridlyGameSettings final : public UObject
 {
 	GENERATED_BODY()
@@ -43,6 +43,32 @@ public:
 	UPROPERTY(Category = "Gridly|Import Settings|Advanced", BlueprintReadOnly, EditAnywhere, Config)
 	int ImportMaxRecordsPerRequest = 1000;
 
+	/** The max amount of pages to request in parallel once the total amount of records in a view is known */
+	UPROPERTY(Category = "Gridly|Import Settings|Advanced", BlueprintReadOnly, EditAnywhere, Config, meta = (ClampMin = 1))
+	int ImportMaxConcurrentRequests = 4;
+
+	/** Only downloads the columns an import reads, rather than every column of the view */
+	UPROPERTY(Category = "Gridly|Import Settings|Advanced", BlueprintReadOnly, EditAnywhere, Config)
+	bool bImportUsedColumnsOnly = true;
+
+	/** Data table imports only add, update and remove the rows that differ from Gridly, instead of rebuilding the whole table */
+	UPROPERTY(Category = "Gridly|Import Settings|Advanced", BlueprintReadOnly, EditAnywhere, Config)
+	bool bPatchDataTablesOnImport = false;
+
+	/** Keeps a copy of the imported records under Saved/Gridly/Sync, so later imports only have to merge the records that changed */
+	UPROPERTY(Category = "Gridly|Import Settings|Advanced", BlueprintReadOnly, EditAnywhere, Config)
+	bool bUseIncrementalImport = false;
+
+	/** Optional query sent on incremental imports, {LastSyncTime} is replaced with the last sync time. When empty, all records are compared by hash */
+	UPROPERTY(Category = "Gridly|Import Settings|Advanced", BlueprintReadOnly, EditAnywhere, Config,
+		meta = (EditCondition = "bUseIncrementalImport"))
+	FString IncrementalImportQuery;
+
+	/** Records deleted in Gridly are only detected by a full import. Forces one when the last was longer ago than this many hours */
+	UPROPERTY(Category = "Gridly|Import Settings|Advanced", BlueprintReadOnly, EditAnywhere, Config,
+		meta = (EditCondition = "bUseIncrementalImport", ClampMin = 0))
+	int IncrementalImportFullSyncHours = 24;
+
 	/** The API key can be retrieved from your Gridly dashboard. Make sure you have write access */
 	UPROPERTY(Category = "Gridly|Export Settings", BlueprintReadOnly, EditAnywhere, Transient)
 	FString ExportApiKey;
@@ -55,6 +81,23 @@ public:
 	UPROPERTY(Category = "Gridly|Export Settings|Advanced", BlueprintReadOnly, EditAnywhere, Config)
 	int ExportMaxRecordsPerRequest = 1000;
 
+	/** Records are packed into export requests up to this estimated body size in bytes, within the record limit above. Set to 0 to only limit by records */
+	UPROPERTY(Category = "Gridly|Export Settings|Advanced", BlueprintReadOnly, EditAnywhere, Config, meta = (ClampMin = 0))
+	int ExportMaxBytesPerRequest = 1048576;
+
+	/** The max amount of export requests to have in flight at the same time */
+	UPROPERTY(Category = "Gridly|Export Settings|Advanced", BlueprintReadOnly, EditAnywhere, Config, meta = (ClampMin = 1))
+	int ExportMaxConcurrentRequests = 4;
+
+	/** Only exports records that are new or changed since the last export, as tracked under Saved/Gridly/ExportLedger */
+	UPROPERTY(Category = "Gridly|Export Settings|Advanced", BlueprintReadOnly, EditAnywhere, Config)
+	bool bExportChangedRecordsOnly = false;
+
+	/** Only sends the cells that changed since the last export, rather than every cell of a changed record */
+	UPROPERTY(Category = "Gridly|Export Settings|Advanced", BlueprintReadOnly, EditAnywhere, Config,
+		meta = (EditCondition = "bExportChangedRecordsOnly"))
+	bool bExportChangedCellsOnly = false;
+
 	/** Use combined comma-separated "{namespace},{key}" as record ID. WARNING! This should not be changed after a project has already been exported */
 	UPROPERTY(Category = "Gridly|Options", BlueprintReadOnly, EditAnywhere, Config)
 	bool bUseCombinedNamespaceId = false;
@@ -107,9 +150,63 @@ public:
 	UPROPERTY(Category = "Gridly|Options", BlueprintReadOnly, EditAnywhere, Config, meta = (EditCondition = "bExportMetadata"))
 	TMap<FString, FGridlyColumnInfo> MetadataMapping;
 
+	/** Requests are sent at up to this rate until Gridly pushes back, after which the rate is lowered and recovers gradually */
+	UPROPERTY(Category = "Gridly|Network Settings", BlueprintReadOnly, EditAnywhere, Config, meta = (ClampMin = 0.1))
+	float MaxRequestsPerSecond = 20.f;
+
+	/** The amount of requests that can be sent in a burst before the rate limit applies */
+	UPROPERTY(Category = "Gridly|Network Settings", BlueprintReadOnly, EditAnywhere, Config, meta = (ClampMin = 1))
+	int RequestBurstSize = 10;
+
+	/** How many times a request is retried after a connection error, a server error or being rate limited by Gridly */
+	UPROPERTY(Category = "Gridly|Network Settings", BlueprintReadOnly, EditAnywhere, Config, meta = (ClampMin = 0))
+	int MaxRequestRetries = 5;
+
+	/** Initial delay in seconds before retrying a request. The delay doubles (with jitter) on every attempt */
+	UPROPERTY(Category = "Gridly|Network Settings", BlueprintReadOnly, EditAnywhere, Config, meta = (ClampMin = 0.0))
+	float RetryBaseDelay = 1.f;
+
+	/** Upper bound in seconds for the delay between retries */
+	UPROPERTY(Category = "Gridly|Network Settings", BlueprintReadOnly, EditAnywhere, Config, meta = (ClampMin = 0.0))
+	float RetryMaxDelay = 30.f;
+
+	/** The max amount of requests to Gridly in flight at the same time, across all imports and exports */
+	UPROPERTY(Category = "Gridly|Network Settings", BlueprintReadOnly, EditAnywhere, Config, meta = (ClampMin = 1))
+	int MaxConcurrentRequests = 8;
+
+	/** A downloaded page is handed to identical requests for this many seconds. Set to 0 to only share downloads that overlap */
+	UPROPERTY(Category = "Gridly|Network Settings", BlueprintReadOnly, EditAnywhere, Config, meta = (ClampMin = 0.0))
+	float ResponseReuseSeconds = 10.f;
+
+	/** Asks Gridly for gzipped responses, which are decompressed before parsing */
+	UPROPERTY(Category = "Gridly|Network Settings", BlueprintReadOnly, EditAnywhere, Config)
+	bool bAcceptCompressedResponses = true;
+
+	/** Keeps downloaded pages under Saved/Gridly/Cache and only downloads them again if they changed in Gridly since */
+	UPROPERTY(Category = "Gridly|Network Settings", BlueprintReadOnly, EditAnywhere, Config)
+	bool bUseResponseCache = false;
+
+	/** Cached pages that have not been used for this many days are deleted when the module starts */
+	UPROPERTY(Category = "Gridly|Network Settings", BlueprintReadOnly, EditAnywhere, Config,
+		meta = (EditCondition = "bUseResponseCache", ClampMin = 1))
+	int ResponseCacheMaxAgeDays = 30;
+
+	/** The least recently used pages are deleted when the module starts until the cache fits in this many megabytes */
+	UPROPERTY(Category = "Gridly|Network Settings", BlueprintReadOnly, EditAnywhere, Config,
+		meta = (EditCondition = "bUseResponseCache", ClampMin = 1))
+	int ResponseCacheMaxSizeMB = 512;
+
+	/** Gzips export request bodies and sends them with Content-Encoding: gzip */
+	UPROPERTY(Category = "Gridly|Network Settings", BlueprintReadOnly, EditAnywhere, Config)
+	bool bCompressRequestBodies = false;
+
 public:
 	UGridlyGameSettings();
 
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
 public:
 	static bool OnSettingsSaved();
 };
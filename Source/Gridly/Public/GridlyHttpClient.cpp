@@ -0,0 +1,475 @@
+﻿// Copyright (c) 2021 LocalizeDirect AB
+
+#include "GridlyHttpClient.h"
+
+#include "Gridly.h"
+#include "GridlyGameSettings.h"
+#include "GridlyHttpCompression.h"
+#include "GridlyRateLimiter.h"
+#include "GridlyResponseCache.h"
+#include "HttpModule.h"
+#include "Containers/Ticker.h"
+#include "GenericPlatform/GenericPlatformHttp.h"
+
+FGridlyHttpClient& FGridlyHttpClient::Get()
+{
+	static FGridlyHttpClient HttpClient;
+	return HttpClient;
+}
+
+FGridlyHttpClient::FGridlyHttpClient() :
+	NextRequestId(1)
+{
+}
+
+FHttpRequestPtr FGridlyHttpClient::CreateRequest(const FString& Verb, const FString& Url, const FString& ApiKey)
+{
+	FHttpRequestPtr HttpRequest = FHttpModule::Get().CreateRequest();
+	HttpRequest->SetHeader(TEXT("Accept"), TEXT("application/json"));
+	HttpRequest->SetHeader(TEXT("Content-Type"), TEXT("application/json"));
+	HttpRequest->SetHeader(TEXT("Authorization"), FString::Printf(TEXT("ApiKey %s"), *ApiKey));
+	FGridlyHttpCompression::AcceptCompressedContent(*HttpRequest);
+
+	HttpRequest->SetVerb(Verb);
+	HttpRequest->SetURL(Url);
+
+	return HttpRequest;
+}
+
+FString FGridlyHttpClient::GetViewRecordsUrl(const FString& ViewId)
+{
+	FStringFormatNamedArguments Args;
+	Args.Add(TEXT("ViewId"), *ViewId);
+	return FString::Format(TEXT("https://api.gridly.com/v1/views/{ViewId}/records"), Args);
+}
+
+FString FGridlyHttpClient::GetViewRecordsPageUrl(const FString& ViewId, int Offset, int Limit, const FString& Query,
+	const TArray<FString>& ColumnIds)
+{
+	const FString PaginationSettings =
+		FGenericPlatformHttp::UrlEncode(FString::Printf(TEXT("{\"offset\":%d,\"limit\":%d}"), Offset, Limit));
+
+	FString Url = FString::Printf(TEXT("%s?page=%s"), *GetViewRecordsUrl(ViewId), *PaginationSettings);
+
+	if (!Query.IsEmpty())
+	{
+		Url += FString::Printf(TEXT("&query=%s"), *FGenericPlatformHttp::UrlEncode(Query));
+	}
+
+	for (const FString& ColumnId : ColumnIds)
+	{
+		Url += FString::Printf(TEXT("&columnIds=%s"), *FGenericPlatformHttp::UrlEncode(ColumnId));
+	}
+
+	return Url;
+}
+
+FGridlyRequestId FGridlyHttpClient::Send(const FHttpRequestPtr& HttpRequest, EGridlyRequestPriority Priority,
+	const FGridlyRequestCompleteDelegate& OnComplete)
+{
+	const FGridlyRequestId RequestId = NextRequestId++;
+	FSubscriber Subscriber{RequestId, OnComplete};
+
+	const FString CoalesceKey = GetCoalesceKey(HttpRequest);
+	if (!CoalesceKey.IsEmpty())
+	{
+		PruneCompletedResponses(FPlatformTime::Seconds());
+
+		if (const FCompletedResponse* CompletedResponse = CompletedResponses.Find(CoalesceKey))
+		{
+			UE_LOG(LogGridly, Log, TEXT("Reusing response of %s"), *HttpRequest->GetURL());
+
+			ReusedResponses.Add(FReusedResponse{MoveTemp(Subscriber), *CompletedResponse});
+			if (!ReuseTickHandle.IsValid())
+			{
+				ReuseTickHandle = FTicker::GetCoreTicker().AddTicker(
+					FTickerDelegate::CreateRaw(this, &FGridlyHttpClient::DeliverReusedResponses));
+			}
+
+			return RequestId;
+		}
+
+		const FGridlyRequestId* CoalescedRequestId = CoalescedRequests.Find(CoalesceKey);
+		if (FRequest* CoalescedRequest = CoalescedRequestId ? FindRequest(*CoalescedRequestId) : nullptr)
+		{
+			UE_LOG(LogGridly, Log, TEXT("Joining pending request of %s"), *HttpRequest->GetURL());
+
+			CoalescedRequest->Subscribers.Add(MoveTemp(Subscriber));
+
+			// A queued background request is moved up once an interactive caller is waiting for it as well
+
+			if (Priority == EGridlyRequestPriority::Interactive && CoalescedRequest->Priority == EGridlyRequestPriority::Background
+			    && !ActiveRequests.Contains(*CoalescedRequestId))
+			{
+				FRequest Request;
+				RemoveQueuedRequest(*CoalescedRequestId, Request);
+				Request.Priority = EGridlyRequestPriority::Interactive;
+				QueuedRequests[static_cast<int>(EGridlyRequestPriority::Interactive)].Add(MoveTemp(Request));
+				Pump();
+			}
+
+			return RequestId;
+		}
+
+		CoalescedRequests.Add(CoalesceKey, RequestId);
+	}
+
+	FRequest Request;
+	Request.Id = RequestId;
+	Request.HttpRequest = HttpRequest;
+	Request.Priority = Priority;
+	Request.Timing.QueuedTime = FPlatformTime::Seconds();
+	Request.CoalesceKey = CoalesceKey;
+	Request.bRevalidating = !CoalesceKey.IsEmpty() && FGridlyResponseCache::IsEnabled()
+	                        && FGridlyResponseCache::IsCacheable(HttpRequest->GetURL())
+	                        && FGridlyResponseCache::AddValidators(CoalesceKey, *HttpRequest);
+	Request.Subscribers.Add(MoveTemp(Subscriber));
+
+	QueuedRequests[static_cast<int>(Priority)].Add(MoveTemp(Request));
+
+	Pump();
+
+	return RequestId;
+}
+
+void FGridlyHttpClient::Cancel(FGridlyRequestId RequestId)
+{
+	const auto IsSubscriber = [RequestId](const FSubscriber& Subscriber)
+	{
+		return Subscriber.Id == RequestId;
+	};
+
+	if (DeliveringIds.RemoveSingleSwap(RequestId, false) > 0)
+	{
+		return;
+	}
+
+	const int ReusedIndex = ReusedResponses.IndexOfByPredicate([RequestId](const FReusedResponse& ReusedResponse)
+	{
+		return ReusedResponse.Subscriber.Id == RequestId;
+	});
+
+	if (ReusedIndex != INDEX_NONE)
+	{
+		ReusedResponses.RemoveAt(ReusedIndex);
+		return;
+	}
+
+	for (TArray<FRequest>& Queue : QueuedRequests)
+	{
+		for (int i = 0; i < Queue.Num(); i++)
+		{
+			if (Queue[i].Subscribers.RemoveAll(IsSubscriber) > 0)
+			{
+				if (Queue[i].Subscribers.Num() == 0)
+				{
+					CoalescedRequests.Remove(Queue[i].CoalesceKey);
+					Queue.RemoveAt(i);
+				}
+
+				return;
+			}
+		}
+	}
+
+	FGridlyRequestId UnusedRequestId = 0;
+	for (TPair<FGridlyRequestId, FRequest>& ActiveRequest : ActiveRequests)
+	{
+		if (ActiveRequest.Value.Subscribers.RemoveAll(IsSubscriber) > 0)
+		{
+			if (ActiveRequest.Value.Subscribers.Num() == 0)
+			{
+				UnusedRequestId = ActiveRequest.Key;
+			}
+
+			break;
+		}
+	}
+
+	// Nobody is waiting for the response anymore
+
+	FRequest Request;
+	if (UnusedRequestId != 0 && ActiveRequests.RemoveAndCopyValue(UnusedRequestId, Request))
+	{
+		Request.HttpRequest->OnProcessRequestComplete().Unbind();
+		Request.HttpRequest->CancelRequest();
+		CoalescedRequests.Remove(Request.CoalesceKey);
+
+		Pump();
+	}
+}
+
+int FGridlyHttpClient::GetNumActiveRequests() const
+{
+	return ActiveRequests.Num();
+}
+
+int FGridlyHttpClient::GetNumQueuedRequests() const
+{
+	return QueuedRequests[0].Num() + QueuedRequests[1].Num();
+}
+
+void FGridlyHttpClient::Shutdown()
+{
+	for (TPair<FGridlyRequestId, FRequest>& ActiveRequest : ActiveRequests)
+	{
+		ActiveRequest.Value.HttpRequest->OnProcessRequestComplete().Unbind();
+		ActiveRequest.Value.HttpRequest->CancelRequest();
+	}
+
+	if (ReuseTickHandle.IsValid())
+	{
+		FTicker::GetCoreTicker().RemoveTicker(ReuseTickHandle);
+		ReuseTickHandle.Reset();
+	}
+
+	ActiveRequests.Empty();
+	QueuedRequests[0].Empty();
+	QueuedRequests[1].Empty();
+	CoalescedRequests.Empty();
+	CompletedResponses.Empty();
+	ReusedResponses.Empty();
+	DeliveringIds.Empty();
+}
+
+void FGridlyHttpClient::Pump()
+{
+	const int MaxConcurrentRequests = FMath::Max(1, GetMutableDefault<UGridlyGameSettings>()->MaxConcurrentRequests);
+
+	// Interactive requests always go first, each queue is served in the order requests were sent
+
+	for (TArray<FRequest>& Queue : QueuedRequests)
+	{
+		while (Queue.Num() > 0 && ActiveRequests.Num() < MaxConcurrentRequests)
+		{
+			FRequest Request = MoveTemp(Queue[0]);
+			Queue.RemoveAt(0);
+			Dispatch(MoveTemp(Request), 0.f);
+		}
+	}
+}
+
+void FGridlyHttpClient::Dispatch(FRequest&& Request, float Delay)
+{
+	const FGridlyRequestId RequestId = Request.Id;
+
+	Request.HttpRequest->OnProcessRequestComplete().BindRaw(this, &FGridlyHttpClient::OnRequestComplete, RequestId);
+	ActiveRequests.Add(RequestId, MoveTemp(Request));
+
+	FGridlyRateLimiter::Get().Schedule([this, RequestId](float ThrottleTime)
+	{
+		// The request may have been cancelled while it was waiting
+
+		if (FRequest* ActiveRequest = ActiveRequests.Find(RequestId))
+		{
+			ActiveRequest->Timing.ThrottleTime += ThrottleTime;
+			ActiveRequest->Timing.StartTime = FPlatformTime::Seconds();
+			ActiveRequest->Timing.Attempts++;
+			ActiveRequest->HttpRequest->ProcessRequest();
+		}
+	}, Delay);
+}
+
+void FGridlyHttpClient::OnRequestComplete(FHttpRequestPtr HttpRequestPtr, FHttpResponsePtr HttpResponsePtr, bool bSuccess,
+	FGridlyRequestId RequestId)
+{
+	FRequest Request;
+	if (!ActiveRequests.RemoveAndCopyValue(RequestId, Request))
+	{
+		return;
+	}
+
+	float RetryDelay = 0.f;
+	if (FGridlyRateLimiter::Get().ProcessResponse(HttpRequestPtr, HttpResponsePtr, bSuccess, Request.Timing.Attempts - 1,
+		RetryDelay))
+	{
+		// A request can only be processed once, so the retry goes out as a copy that keeps its slot
+
+		Request.HttpRequest = CloneRequest(HttpRequestPtr, true);
+		Request.Timing.ThrottleTime += RetryDelay;
+		Dispatch(MoveTemp(Request), RetryDelay);
+		return;
+	}
+
+	int32 ResponseCode = HttpResponsePtr.IsValid() ? HttpResponsePtr->GetResponseCode() : 0;
+
+	if (bSuccess && Request.bRevalidating && ResponseCode == EHttpResponseCodes::NotModified)
+	{
+		if (const FHttpResponsePtr CachedResponsePtr = FGridlyResponseCache::Load(Request.CoalesceKey, HttpRequestPtr->GetURL()))
+		{
+			UE_LOG(LogGridly, Log, TEXT("Serving %s from the response cache"), *HttpRequestPtr->GetURL());
+
+			HttpResponsePtr = CachedResponsePtr;
+			ResponseCode = EHttpResponseCodes::Ok;
+		}
+		else
+		{
+			// The entry went missing or is corrupt, so ask for the whole page again
+
+			FGridlyResponseCache::Remove(Request.CoalesceKey);
+
+			Request.HttpRequest = CloneRequest(HttpRequestPtr, false);
+			Request.bRevalidating = false;
+			Dispatch(MoveTemp(Request), 0.f);
+			return;
+		}
+	}
+	else if (bSuccess && ResponseCode == EHttpResponseCodes::Ok && !Request.CoalesceKey.IsEmpty()
+	         && FGridlyResponseCache::IsEnabled() && FGridlyResponseCache::IsCacheable(HttpRequestPtr->GetURL()))
+	{
+		FGridlyResponseCache::Store(Request.CoalesceKey, HttpResponsePtr);
+	}
+
+	Request.Timing.EndTime = FPlatformTime::Seconds();
+
+	UE_LOG(LogGridly, Log, TEXT("%s %s finished with %d after %.2f seconds (%d attempts, %.2f seconds throttled)"),
+		*HttpRequestPtr->GetVerb(), *HttpRequestPtr->GetURL(), ResponseCode, Request.Timing.GetTotalTime(),
+		Request.Timing.Attempts, Request.Timing.ThrottleTime);
+
+	if (!Request.CoalesceKey.IsEmpty())
+	{
+		CoalescedRequests.Remove(Request.CoalesceKey);
+
+		if (bSuccess && ResponseCode == EHttpResponseCodes::Ok
+		    && GetMutableDefault<UGridlyGameSettings>()->ResponseReuseSeconds > 0.f)
+		{
+			CompletedResponses.Add(Request.CoalesceKey, FCompletedResponse{HttpRequestPtr, HttpResponsePtr, Request.Timing});
+		}
+	}
+
+	// Free the slot before the callers react, they will usually send their next request straight away
+
+	Pump();
+
+	for (const FSubscriber& Subscriber : Request.Subscribers)
+	{
+		DeliveringIds.Add(Subscriber.Id);
+	}
+
+	for (const FSubscriber& Subscriber : Request.Subscribers)
+	{
+		// Skipped if an earlier subscriber cancelled it
+		if (DeliveringIds.RemoveSingleSwap(Subscriber.Id, false) > 0)
+		{
+			Subscriber.OnComplete.ExecuteIfBound(HttpRequestPtr, HttpResponsePtr, bSuccess, Request.Timing);
+		}
+	}
+}
+
+FGridlyHttpClient::FRequest* FGridlyHttpClient::FindRequest(FGridlyRequestId RequestId)
+{
+	if (FRequest* ActiveRequest = ActiveRequests.Find(RequestId))
+	{
+		return ActiveRequest;
+	}
+
+	for (TArray<FRequest>& Queue : QueuedRequests)
+	{
+		for (FRequest& Request : Queue)
+		{
+			if (Request.Id == RequestId)
+			{
+				return &Request;
+			}
+		}
+	}
+
+	return nullptr;
+}
+
+void FGridlyHttpClient::RemoveQueuedRequest(FGridlyRequestId RequestId, FRequest& OutRequest)
+{
+	for (TArray<FRequest>& Queue : QueuedRequests)
+	{
+		for (int i = 0; i < Queue.Num(); i++)
+		{
+			if (Queue[i].Id == RequestId)
+			{
+				OutRequest = MoveTemp(Queue[i]);
+				Queue.RemoveAt(i);
+				return;
+			}
+		}
+	}
+}
+
+void FGridlyHttpClient::PruneCompletedResponses(double Now)
+{
+	const double ReuseSeconds = GetMutableDefault<UGridlyGameSettings>()->ResponseReuseSeconds;
+
+	for (auto It = CompletedResponses.CreateIterator(); It; ++It)
+	{
+		if (Now - It.Value().Timing.EndTime > ReuseSeconds)
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+bool FGridlyHttpClient::DeliverReusedResponses(float DeltaTime)
+{
+	// Callers may send new requests from their delegate, which can add to the list again
+
+	TArray<FReusedResponse> Responses = MoveTemp(ReusedResponses);
+	ReusedResponses.Reset();
+
+	for (const FReusedResponse& Response : Responses)
+	{
+		DeliveringIds.Add(Response.Subscriber.Id);
+	}
+
+	for (const FReusedResponse& Response : Responses)
+	{
+		// Skipped if an earlier subscriber cancelled it
+		if (DeliveringIds.RemoveSingleSwap(Response.Subscriber.Id, false) > 0)
+		{
+			Response.Subscriber.OnComplete.ExecuteIfBound(Response.Response.HttpRequest, Response.Response.HttpResponse, true,
+				Response.Response.Timing);
+		}
+	}
+
+	if (ReusedResponses.Num() == 0)
+	{
+		ReuseTickHandle.Reset();
+		return false;
+	}
+
+	return true;
+}
+
+FString FGridlyHttpClient::GetCoalesceKey(const FHttpRequestPtr& HttpRequest)
+{
+	// Only reads can be shared, the API key is part of the key since it decides what the response contains
+
+	if (HttpRequest->GetVerb() != TEXT("GET"))
+	{
+		return FString();
+	}
+
+	return HttpRequest->GetURL() + TEXT("|") + HttpRequest->GetHeader(TEXT("Authorization"));
+}
+
+FHttpRequestPtr FGridlyHttpClient::CloneRequest(const FHttpRequestPtr& HttpRequest, bool bKeepValidators)
+{
+	FHttpRequestPtr ClonedRequest = FHttpModule::Get().CreateRequest();
+	ClonedRequest->SetVerb(HttpRequest->GetVerb());
+	ClonedRequest->SetURL(HttpRequest->GetURL());
+
+	for (const FString& Header : HttpRequest->GetAllHeaders())
+	{
+		FString Name;
+		FString Value;
+		if (Header.Split(TEXT(":"), &Name, &Value) && Name != TEXT("Content-Length")
+		    && (bKeepValidators || (Name != TEXT("If-None-Match") && Name != TEXT("If-Modified-Since"))))
+		{
+			ClonedRequest->SetHeader(Name.TrimStartAndEnd(), Value.TrimStartAndEnd());
+		}
+	}
+
+	if (HttpRequest->GetContentLength() > 0)
+	{
+		ClonedRequest->SetContent(HttpRequest->GetContent());
+	}
+
+	return ClonedRequest;
+}
@@ -0,0 +1,149 @@
+﻿// Copyright (c) 2021 LocalizeDirect AB
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Interfaces/IHttpRequest.h"
+#include "Interfaces/IHttpResponse.h"
+
+enum class EGridlyRequestPriority : uint8
+{
+	/** Started by the user in the editor, sent before any queued background request */
+	Interactive,
+	Background
+};
+
+struct FGridlyRequestTiming
+{
+	/** When the request was handed to the client */
+	double QueuedTime = 0.0;
+
+	/** When the last attempt was sent */
+	double StartTime = 0.0;
+
+	double EndTime = 0.0;
+
+	/** Seconds spent waiting on the rate limiter and retry back off */
+	float ThrottleTime = 0.f;
+
+	int Attempts = 0;
+
+	double GetTotalTime() const { return EndTime - QueuedTime; }
+	double GetResponseTime() const { return EndTime - StartTime; }
+};
+
+DECLARE_DELEGATE_FourParams(FGridlyRequestCompleteDelegate, FHttpRequestPtr, FHttpResponsePtr, bool /* bSuccess */,
+	const FGridlyRequestTiming&);
+
+typedef uint64 FGridlyRequestId;
+
+/**
+ * Sends all requests to Gridly. Requests are queued by priority and at most MaxConcurrentRequests are in flight across every
+ * import and export, which lets the HTTP backend keep reusing the same few connections. Every request goes through the
+ * shared rate limiter, and failed attempts are retried here so callers only ever see the final response.
+ *
+ * Identical GET requests (same URL and API key) share a single download, and a successful response is handed to new
+ * callers for ResponseReuseSeconds after it arrived. With bUseResponseCache they are also revalidated against the copy in
+ * FGridlyResponseCache, and a 304 Not Modified reaches callers as the cached 200 response.
+ */
+class GRIDLY_API FGridlyHttpClient
+{
+public:
+	static FGridlyHttpClient& Get();
+
+	FGridlyHttpClient();
+
+	/** Creates a request with the headers every Gridly endpoint expects */
+	static FHttpRequestPtr CreateRequest(const FString& Verb, const FString& Url, const FString& ApiKey);
+
+	static FString GetViewRecordsUrl(const FString& ViewId);
+	/** Only the given columns are included in the records when ColumnIds is not empty */
+	static FString GetViewRecordsPageUrl(const FString& ViewId, int Offset, int Limit, const FString& Query = FString(),
+		const TArray<FString>& ColumnIds = TArray<FString>());
+
+	/**
+	 * Queues the request, the delegate is called once with the final response unless the request is cancelled first. It is
+	 * never called from within Send, even when the response is reused
+	 */
+	FGridlyRequestId Send(const FHttpRequestPtr& HttpRequest, EGridlyRequestPriority Priority,
+		const FGridlyRequestCompleteDelegate& OnComplete);
+
+	/** Stops the delegate from being called. The download itself is only cancelled once no other caller is waiting for it */
+	void Cancel(FGridlyRequestId RequestId);
+
+	int GetNumActiveRequests() const;
+	int GetNumQueuedRequests() const;
+
+	void Shutdown();
+
+private:
+	struct FSubscriber
+	{
+		FGridlyRequestId Id;
+		FGridlyRequestCompleteDelegate OnComplete;
+	};
+
+	struct FRequest
+	{
+		FGridlyRequestId Id;
+		FHttpRequestPtr HttpRequest;
+		EGridlyRequestPriority Priority;
+		FGridlyRequestTiming Timing;
+
+		// Empty if the request can not be shared
+		FString CoalesceKey;
+
+		// Sent with the validators of a cached response, a 304 is answered from the cache
+		bool bRevalidating = false;
+
+		TArray<FSubscriber> Subscribers;
+	};
+
+	struct FCompletedResponse
+	{
+		FHttpRequestPtr HttpRequest;
+		FHttpResponsePtr HttpResponse;
+		FGridlyRequestTiming Timing;
+	};
+
+	struct FReusedResponse
+	{
+		FSubscriber Subscriber;
+		FCompletedResponse Response;
+	};
+
+	void Pump();
+	void Dispatch(FRequest&& Request, float Delay);
+	void OnRequestComplete(FHttpRequestPtr HttpRequestPtr, FHttpResponsePtr HttpResponsePtr, bool bSuccess,
+		FGridlyRequestId RequestId);
+
+	FRequest* FindRequest(FGridlyRequestId RequestId);
+	void RemoveQueuedRequest(FGridlyRequestId RequestId, FRequest& OutRequest);
+	void PruneCompletedResponses(double Now);
+	bool DeliverReusedResponses(float DeltaTime);
+
+	static FString GetCoalesceKey(const FHttpRequestPtr& HttpRequest);
+	static FHttpRequestPtr CloneRequest(const FHttpRequestPtr& HttpRequest, bool bKeepValidators);
+
+	FGridlyRequestId NextRequestId;
+
+	// Waiting for a slot, one queue per priority
+	TArray<FRequest> QueuedRequests[2];
+
+	// Sent, or holding a slot while waiting for the rate limiter
+	TMap<FGridlyRequestId, FRequest> ActiveRequests;
+
+	// Queued or active requests that new callers can subscribe to, by coalesce key
+	TMap<FString, FGridlyRequestId> CoalescedRequests;
+
+	// Successful responses that may still be reused, by coalesce key
+	TMap<FString, FCompletedResponse> CompletedResponses;
+
+	// Reused responses are delivered from the core ticker, so callers always get their request ID first
+	TArray<FReusedResponse> ReusedResponses;
+	FDelegateHandle ReuseTickHandle;
+
+	// Subscribers of the responses being delivered whose callbacks have not run yet, so an earlier callback can cancel them
+	TArray<FGridlyRequestId> DeliveringIds;
+};
@@ -0,0 +1,125 @@
+﻿// Copyright (c) 2021 LocalizeDirect AB
+
+#include "GridlyHttpCompression.h"
+
+#include "Gridly.h"
+#include "GridlyGameSettings.h"
+#include "Misc/Compression.h"
+
+namespace GridlyHttpCompression
+{
+// 10 byte header and 8 byte trailer of an empty gzip member
+constexpr int32 MinCompressedSize = 18;
+}
+
+void FGridlyHttpCompression::AcceptCompressedContent(IHttpRequest& HttpRequest)
+{
+	if (GetMutableDefault<UGridlyGameSettings>()->bAcceptCompressedResponses)
+	{
+		HttpRequest.SetHeader(TEXT("Accept-Encoding"), TEXT("gzip"));
+	}
+}
+
+void FGridlyHttpCompression::SetContent(IHttpRequest& HttpRequest, const FString& Content)
+{
+	if (GetMutableDefault<UGridlyGameSettings>()->bCompressRequestBodies)
+	{
+		const FTCHARToUTF8 Converter(*Content, Content.Len());
+
+		TArray<uint8> CompressedContent;
+		if (Compress(reinterpret_cast<const uint8*>(Converter.Get()), Converter.Length(), CompressedContent))
+		{
+			HttpRequest.SetHeader(TEXT("Content-Encoding"), TEXT("gzip"));
+			HttpRequest.SetContent(CompressedContent);
+			return;
+		}
+
+		UE_LOG(LogGridly, Warning, TEXT("Failed to compress request body, sending it uncompressed"));
+	}
+
+	HttpRequest.SetContentAsString(Content);
+}
+
+const TArray<uint8>& FGridlyHttpCompression::GetContent(const FHttpResponsePtr& HttpResponsePtr, TArray<uint8>& OutBuffer)
+{
+	const TArray<uint8>& Content = HttpResponsePtr->GetContent();
+
+	if (IsCompressed(Content))
+	{
+		if (Decompress(Content, OutBuffer))
+		{
+			return OutBuffer;
+		}
+
+		UE_LOG(LogGridly, Warning, TEXT("Failed to decompress response body of %d bytes"), Content.Num());
+	}
+
+	return Content;
+}
+
+FString FGridlyHttpCompression::GetContentAsString(const FHttpResponsePtr& HttpResponsePtr)
+{
+	TArray<uint8> Buffer;
+	const TArray<uint8>& Content = GetContent(HttpResponsePtr, Buffer);
+
+	// Same conversion as IHttpResponse::GetContentAsString
+	const FUTF8ToTCHAR Converter(reinterpret_cast<const ANSICHAR*>(Content.GetData()), Content.Num());
+	return FString(Converter.Length(), Converter.Get());
+}
+
+bool FGridlyHttpCompression::IsCompressed(const TArray<uint8>& Content)
+{
+	return IsCompressed(Content.GetData(), Content.Num());
+}
+
+bool FGridlyHttpCompression::IsCompressed(const uint8* Content, int64 Size)
+{
+	return Size >= GridlyHttpCompression::MinCompressedSize && Content[0] == 0x1f && Content[1] == 0x8b;
+}
+
+bool FGridlyHttpCompression::Compress(const uint8* Data, int32 Size, TArray<uint8>& OutCompressed)
+{
+	int32 CompressedSize = FCompression::CompressMemoryBound(NAME_Gzip, Size);
+	OutCompressed.SetNumUninitialized(CompressedSize);
+
+	if (!FCompression::CompressMemory(NAME_Gzip, OutCompressed.GetData(), CompressedSize, Data, Size))
+	{
+		OutCompressed.Reset();
+		return false;
+	}
+
+	OutCompressed.SetNum(CompressedSize, false);
+	return true;
+}
+
+bool FGridlyHttpCompression::Decompress(const TArray<uint8>& Compressed, TArray<uint8>& OutData)
+{
+	return Decompress(Compressed.GetData(), Compressed.Num(), OutData);
+}
+
+bool FGridlyHttpCompression::Decompress(const uint8* Compressed, int64 CompressedSize, TArray<uint8>& OutData)
+{
+	if (!IsCompressed(Compressed, CompressedSize) || CompressedSize > MAX_int32)
+	{
+		return false;
+	}
+
+	// The uncompressed size (modulo 2^32) is stored little endian in the last four bytes
+
+	const uint8* SizeField = Compressed + CompressedSize - 4;
+	const uint32 UncompressedSize = SizeField[0] | SizeField[1] << 8 | SizeField[2] << 16 | static_cast<uint32>(SizeField[3]) << 24;
+	if (UncompressedSize > static_cast<uint32>(MAX_int32))
+	{
+		return false;
+	}
+
+	OutData.SetNumUninitialized(static_cast<int32>(UncompressedSize));
+
+	if (!FCompression::UncompressMemory(NAME_Gzip, OutData.GetData(), OutData.Num(), Compressed, static_cast<int32>(CompressedSize)))
+	{
+		OutData.Reset();
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,32 @@
+﻿// Copyright (c) 2021 LocalizeDirect AB
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Interfaces/IHttpRequest.h"
+#include "Interfaces/IHttpResponse.h"
+
+/**
+ * gzip handling for requests sent to Gridly. Responses are only decoded when they still start with the gzip magic bytes,
+ * since some HTTP backends already decode them on their own.
+ */
+class GRIDLY_API FGridlyHttpCompression
+{
+public:
+	/** Asks for a gzipped response when bAcceptCompressedResponses is set */
+	static void AcceptCompressedContent(IHttpRequest& HttpRequest);
+
+	/** Sets the body as UTF-8, gzipped when bCompressRequestBodies is set */
+	static void SetContent(IHttpRequest& HttpRequest, const FString& Content);
+
+	/** The response body, either as received or decompressed into OutBuffer */
+	static const TArray<uint8>& GetContent(const FHttpResponsePtr& HttpResponsePtr, TArray<uint8>& OutBuffer);
+	static FString GetContentAsString(const FHttpResponsePtr& HttpResponsePtr);
+
+	static bool IsCompressed(const TArray<uint8>& Content);
+	static bool IsCompressed(const uint8* Content, int64 Size);
+	static bool Compress(const uint8* Data, int32 Size, TArray<uint8>& OutCompressed);
+	static bool Decompress(const TArray<uint8>& Compressed, TArray<uint8>& OutData);
+	static bool Decompress(const uint8* Compressed, int64 CompressedSize, TArray<uint8>& OutData);
+};
@@ -3,7 +3,7 @@
 #include "GridlyLocalizedTextConverter.h"
 
 #include "Gridly.h"
-#include "GridlyCultureConverter.h"
+#include "GridlyColumnSchema.h"
 #include "GridlyDataTableImporterJSON.h"
 #include "GridlyGameSettings.h"
 #include "Internationalization/PolyglotTextData.h"
@@ -12,12 +12,16 @@
 bool FGridlyLocalizedTextConverter::TableRowsToPolyglotTextDatas(
 	const TArray<FGridlyTableRow>& TableRows, TMap<FString, FPolyglotTextData>& OutPolyglotTextDatas)
 {
-	UGridlyGameSettings* GameSettings = GetMutableDefault<UGridlyGameSettings>();
-	const TArray<FString> TargetCultures = FGridlyCultureConverter::GetTargetCultures();
+	FGridlyColumnSchema ColumnSchema;
+	return TableRowsToPolyglotTextDatas(ColumnSchema, TableRows, OutPolyglotTextDatas);
+}
 
-	const bool bUseCombinedNamespaceKey = GameSettings->bUseCombinedNamespaceId;
-	const bool bUsedMakeUniqueRecordId = GameSettings->bMakeUniqueRecordId;
-	const bool bUsePathAsNamespace = !bUseCombinedNamespaceKey && GameSettings->NamespaceColumnId == "path";
+bool FGridlyLocalizedTextConverter::TableRowsToPolyglotTextDatas(FGridlyColumnSchema& ColumnSchema,
+	const TArray<FGridlyTableRow>& TableRows, TMap<FString, FPolyglotTextData>& OutPolyglotTextDatas)
+{
+	const bool bUseCombinedNamespaceKey = ColumnSchema.UseCombinedNamespaceKey();
+	const bool bUsedMakeUniqueRecordId = ColumnSchema.MakeUniqueRecordId();
+	const bool bUsePathAsNamespace = ColumnSchema.UsePathAsNamespace();
 
 	for (int i = 0; i < TableRows.Num(); i++)
 	{
@@ -33,35 +37,22 @@ bool FGridlyLocalizedTextConverter::TableRowsToPolyglotTextDatas(
 		for (int j = 0; j < TableRows[i].Cells.Num(); j++)
 		{
 			const FGridlyTableCell& GridlyTableCell = TableRows[i].Cells[j];
+			const FGridlyColumnDescriptor& ColumnDescriptor = ColumnSchema.Resolve(GridlyTableCell.ColumnId);
 
-			// If special columns
-
-			if (!bUsePathAsNamespace && GridlyTableCell.ColumnId == GameSettings->NamespaceColumnId)
+			switch (ColumnDescriptor.Role)
 			{
+			case EGridlyColumnRole::Namespace:
 				Namespace = GridlyTableCell.Value;
-				continue;
-			}
-
-			// If language column
-
-			if (GridlyTableCell.ColumnId.StartsWith(GameSettings->SourceLanguageColumnIdPrefix))
-			{
-				const FString GridlyCulture = GridlyTableCell.ColumnId.RightChop(GameSettings->SourceLanguageColumnIdPrefix.Len());
-				FString Culture;
-				if (FGridlyCultureConverter::ConvertFromGridly(TargetCultures, GridlyCulture, Culture))
-				{
-					SourceCulture = Culture;
-					SourceText = GridlyTableCell.Value;
-				}
-			}
-			else if (GridlyTableCell.ColumnId.StartsWith(GameSettings->TargetLanguageColumnIdPrefix))
-			{
-				const FString GridlyCulture = GridlyTableCell.ColumnId.RightChop(GameSettings->TargetLanguageColumnIdPrefix.Len());
-				FString Culture;
-				if (FGridlyCultureConverter::ConvertFromGridly(TargetCultures, GridlyCulture, Culture))
-				{
-					Translations.Add(Culture, GridlyTableCell.Value);
-				}
+				break;
+			case EGridlyColumnRole::Source:
+				SourceCulture = ColumnDescriptor.Culture;
+				SourceText = GridlyTableCell.Value;
+				break;
+			case EGridlyColumnRole::Target:
+				Translations.Add(ColumnDescriptor.Culture, GridlyTableCell.Value);
+				break;
+			default:
+				break;
 			}
 		}
 
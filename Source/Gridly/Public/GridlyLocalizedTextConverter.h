@@ -6,10 +6,14 @@
 
 #include "GridlyTableRow.h"
 
+class FGridlyColumnSchema;
+
 class GRIDLY_API FGridlyLocalizedTextConverter
 {
 public:
 	static bool TableRowsToPolyglotTextDatas(const TArray<FGridlyTableRow>& TableRows,
 		TMap<FString, FPolyglotTextData>& OutPolyglotTextDatas);
+	static bool TableRowsToPolyglotTextDatas(FGridlyColumnSchema& ColumnSchema, const TArray<FGridlyTableRow>& TableRows,
+		TMap<FString, FPolyglotTextData>& OutPolyglotTextDatas);
 	static bool WritePoFile(const TArray<FPolyglotTextData>& PolyglotTextDatas, const FString& TargetCulture, const FString& Path);
 };
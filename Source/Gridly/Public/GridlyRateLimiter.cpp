@@ -0,0 +1,232 @@
+﻿// Copyright (c) 2021 LocalizeDirect AB
+
+#include "GridlyRateLimiter.h"
+
+#include "Gridly.h"
+#include "GridlyGameSettings.h"
+#include "Containers/Ticker.h"
+
+namespace GridlyRateLimiter
+{
+// Lowest rate the limiter will back off to after repeated push back from the server
+constexpr double MinRequestsPerSecond = .5;
+}
+
+FGridlyRateLimiter& FGridlyRateLimiter::Get()
+{
+	static FGridlyRateLimiter RateLimiter;
+	return RateLimiter;
+}
+
+FGridlyRateLimiter::FGridlyRateLimiter() :
+	Tokens(-1.0),
+	RequestsPerSecond(-1.0),
+	LastRefillTime(FPlatformTime::Seconds()),
+	BlockedUntil(0.0),
+	TotalThrottleTime(0.0)
+{
+}
+
+void FGridlyRateLimiter::Schedule(FDispatchFunction&& DispatchFunction, float Delay)
+{
+	const double Now = FPlatformTime::Seconds();
+	RefillTokens(Now);
+
+	if (Delay <= 0.f && PendingRequests.Num() == 0 && Now >= BlockedUntil && Tokens >= 1.0)
+	{
+		Dispatch(DispatchFunction, Now, Now);
+		return;
+	}
+
+	PendingRequests.Add(FPendingRequest{MoveTemp(DispatchFunction), Now, Now + FMath::Max(0.f, Delay)});
+
+	if (!TickHandle.IsValid())
+	{
+		TickHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FGridlyRateLimiter::Tick));
+	}
+}
+
+bool FGridlyRateLimiter::ProcessResponse(FHttpRequestPtr HttpRequestPtr, FHttpResponsePtr HttpResponsePtr, bool bSuccess,
+	int Attempt, float& OutRetryDelay)
+{
+	const UGridlyGameSettings* GameSettings = GetMutableDefault<UGridlyGameSettings>();
+	const double MaxRequestsPerSecond = FMath::Max(static_cast<double>(GameSettings->MaxRequestsPerSecond),
+		GridlyRateLimiter::MinRequestsPerSecond);
+	const double Now = FPlatformTime::Seconds();
+	RefillTokens(Now);
+
+	const int32 ResponseCode = bSuccess && HttpResponsePtr.IsValid() ? HttpResponsePtr->GetResponseCode() : 0;
+	const bool bThrottled = ResponseCode == EHttpResponseCodes::TooManyRequests;
+	const bool bServerError = ResponseCode == EHttpResponseCodes::ServerError || ResponseCode == EHttpResponseCodes::BadGateway
+	                          || ResponseCode == EHttpResponseCodes::ServiceUnavail
+	                          || ResponseCode == EHttpResponseCodes::GatewayTimeout;
+
+	// Honor explicit instructions from the server before anything else
+
+	float ServerDelay = 0.f;
+	if (HttpResponsePtr.IsValid())
+	{
+		ServerDelay = GetHeaderDelay(HttpResponsePtr, TEXT("Retry-After"));
+
+		FString Remaining = HttpResponsePtr->GetHeader(TEXT("X-RateLimit-Remaining"));
+		const TCHAR* ResetHeaderName = TEXT("X-RateLimit-Reset");
+		if (Remaining.IsEmpty())
+		{
+			Remaining = HttpResponsePtr->GetHeader(TEXT("RateLimit-Remaining"));
+			ResetHeaderName = TEXT("RateLimit-Reset");
+		}
+
+		if (Remaining.IsNumeric() && FCString::Atoi(*Remaining) <= 0)
+		{
+			ServerDelay = FMath::Max(ServerDelay, GetHeaderDelay(HttpResponsePtr, ResetHeaderName));
+		}
+	}
+
+	if (ServerDelay > 0.f)
+	{
+		BlockedUntil = FMath::Max(BlockedUntil, Now + ServerDelay);
+	}
+
+	if (bThrottled)
+	{
+		// Multiplicative decrease on push back
+
+		RequestsPerSecond = FMath::Max(RequestsPerSecond * .5, GridlyRateLimiter::MinRequestsPerSecond);
+		Tokens = FMath::Min(Tokens, 0.0);
+		UE_LOG(LogGridly, Warning, TEXT("Rate limited by Gridly, lowering request rate to %.2f/s"), RequestsPerSecond);
+	}
+	else if (ResponseCode >= 200 && ResponseCode < 400)
+	{
+		// Additive increase while the server keeps up
+
+		RequestsPerSecond = FMath::Min(RequestsPerSecond + 1.0, MaxRequestsPerSecond);
+	}
+
+	// A POST whose response was lost or failed may still have been applied, so it is only sent again if the server turned it
+	// down or the connection was never made
+
+	const FString Verb = HttpRequestPtr.IsValid() ? HttpRequestPtr->GetVerb() : FString();
+	const bool bIdempotent = !Verb.Equals(TEXT("POST"), ESearchCase::IgnoreCase)
+	                         && !Verb.Equals(TEXT("PATCH"), ESearchCase::IgnoreCase);
+	const bool bNotSent = !bSuccess && HttpRequestPtr.IsValid()
+	                      && HttpRequestPtr->GetStatus() == EHttpRequestStatus::Failed_ConnectionError;
+
+	const bool bRetryable = bIdempotent ? !bSuccess || bThrottled || bServerError : bThrottled || bNotSent;
+	const bool bShouldRetry = bRetryable && Attempt < GameSettings->MaxRequestRetries;
+	if (bShouldRetry)
+	{
+		const float Backoff = FMath::Min(GameSettings->RetryBaseDelay * FMath::Pow(2.f, static_cast<float>(Attempt)),
+			GameSettings->RetryMaxDelay);
+		OutRetryDelay = FMath::Max(Backoff * FMath::FRandRange(.5f, 1.f), ServerDelay);
+
+		UE_LOG(LogGridly, Log, TEXT("Retrying request (attempt %d of %d) in %.2f seconds, response code: %d"), Attempt + 1,
+			GameSettings->MaxRequestRetries, OutRetryDelay, ResponseCode);
+	}
+
+	return bShouldRetry;
+}
+
+double FGridlyRateLimiter::GetTotalThrottleTime() const
+{
+	return TotalThrottleTime;
+}
+
+void FGridlyRateLimiter::Shutdown()
+{
+	if (TickHandle.IsValid())
+	{
+		FTicker::GetCoreTicker().RemoveTicker(TickHandle);
+		TickHandle.Reset();
+	}
+
+	PendingRequests.Empty();
+}
+
+bool FGridlyRateLimiter::Tick(float DeltaTime)
+{
+	const double Now = FPlatformTime::Seconds();
+	RefillTokens(Now);
+
+	if (Now >= BlockedUntil)
+	{
+		for (int i = 0; i < PendingRequests.Num() && Tokens >= 1.0;)
+		{
+			if (PendingRequests[i].ReadyTime <= Now)
+			{
+				FPendingRequest PendingRequest = MoveTemp(PendingRequests[i]);
+				PendingRequests.RemoveAt(i);
+				Dispatch(PendingRequest.DispatchFunction, PendingRequest.QueuedTime, Now);
+			}
+			else
+			{
+				i++;
+			}
+		}
+	}
+
+	if (PendingRequests.Num() == 0)
+	{
+		TickHandle.Reset();
+		return false;
+	}
+
+	return true;
+}
+
+void FGridlyRateLimiter::RefillTokens(double Now)
+{
+	const UGridlyGameSettings* GameSettings = GetMutableDefault<UGridlyGameSettings>();
+	const double MaxRequestsPerSecond = FMath::Max(static_cast<double>(GameSettings->MaxRequestsPerSecond),
+		GridlyRateLimiter::MinRequestsPerSecond);
+	const double BurstSize = FMath::Max(GameSettings->RequestBurstSize, 1);
+
+	if (RequestsPerSecond < 0.0)
+	{
+		RequestsPerSecond = MaxRequestsPerSecond;
+		Tokens = BurstSize;
+	}
+
+	RequestsPerSecond = FMath::Min(RequestsPerSecond, MaxRequestsPerSecond);
+	Tokens = FMath::Min(Tokens + (Now - LastRefillTime) * RequestsPerSecond, BurstSize);
+	LastRefillTime = Now;
+}
+
+void FGridlyRateLimiter::Dispatch(FDispatchFunction& DispatchFunction, double QueuedTime, double Now)
+{
+	Tokens -= 1.0;
+
+	const float ThrottleTime = static_cast<float>(Now - QueuedTime);
+	TotalThrottleTime += ThrottleTime;
+
+	DispatchFunction(ThrottleTime);
+}
+
+float FGridlyRateLimiter::GetHeaderDelay(FHttpResponsePtr HttpResponsePtr, const TCHAR* HeaderName)
+{
+	const FString HeaderValue = HttpResponsePtr->GetHeader(HeaderName).TrimStartAndEnd();
+	if (HeaderValue.IsEmpty())
+	{
+		return 0.f;
+	}
+
+	if (HeaderValue.IsNumeric())
+	{
+		const double Value = FCString::Atod(*HeaderValue);
+
+		// Rate limit reset headers are either relative seconds or a Unix timestamp
+		if (Value > 1000000000.0)
+		{
+			return FMath::Max(0.f, static_cast<float>(Value - FDateTime::UtcNow().ToUnixTimestamp()));
+		}
+
+		return FMath::Max(0.f, static_cast<float>(Value));
+	}
+
+	FDateTime DateTime;
+	if (FDateTime::ParseHttpDate(HeaderValue, DateTime))
+	{
+		return FMath::Max(0.f, static_cast<float>((DateTime - FDateTime::UtcNow()).GetTotalSeconds()));
+	}
+
+	return 0.f;
+}
@@ -0,0 +1,62 @@
+﻿// Copyright (c) 2021 LocalizeDirect AB
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Interfaces/IHttpRequest.h"
+#include "Interfaces/IHttpResponse.h"
+
+/**
+ * Token bucket shared by all requests sent to Gridly. Requests go out at full speed until the server pushes back,
+ * after which the rate is lowered and retries are backed off exponentially with jitter. Delayed requests are
+ * dispatched from the core ticker, so no thread is ever put to sleep.
+ */
+class GRIDLY_API FGridlyRateLimiter
+{
+public:
+	/** Called when the request can be sent, with the amount of seconds it was held back */
+	typedef TFunction<void(float ThrottleTime)> FDispatchFunction;
+
+	static FGridlyRateLimiter& Get();
+
+	FGridlyRateLimiter();
+
+	/** Dispatches the request as soon as the rate limit allows it, but no sooner than after the given delay */
+	void Schedule(FDispatchFunction&& DispatchFunction, float Delay = 0.f);
+
+	/**
+	 * Adapts the rate to a response. Returns true if the request should be retried after OutRetryDelay seconds. Requests that
+	 * are not idempotent, such as POST, are only retried if the server cannot have applied them
+	 */
+	bool ProcessResponse(FHttpRequestPtr HttpRequestPtr, FHttpResponsePtr HttpResponsePtr, bool bSuccess, int Attempt,
+		float& OutRetryDelay);
+
+	/** Total seconds that requests have been held back by the limiter */
+	double GetTotalThrottleTime() const;
+
+	void Shutdown();
+
+private:
+	struct FPendingRequest
+	{
+		FDispatchFunction DispatchFunction;
+		double QueuedTime;
+		double ReadyTime;
+	};
+
+	bool Tick(float DeltaTime);
+	void RefillTokens(double Now);
+	void Dispatch(FDispatchFunction& DispatchFunction, double QueuedTime, double Now);
+
+	static float GetHeaderDelay(FHttpResponsePtr HttpResponsePtr, const TCHAR* HeaderName);
+
+	TArray<FPendingRequest> PendingRequests;
+	FDelegateHandle TickHandle;
+
+	double Tokens;
+	double RequestsPerSecond;
+	double LastRefillTime;
+	double BlockedUntil;
+	double TotalThrottleTime;
+};
@@ -0,0 +1,652 @@
+﻿// Copyright (c) 2021 LocalizeDirect AB
+
+#include "GridlyRecordsParser.h"
+
+#include "Gridly.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "JsonObjectConverter.h"
+#include "Misc/FileHelper.h"
+
+namespace GridlyRecordsParser
+{
+bool IsNumberChar(uint8 Char)
+{
+	return (Char >= '0' && Char <= '9') || Char == '-' || Char == '+' || Char == '.' || Char == 'e' || Char == 'E';
+}
+
+bool IsLiteralChar(uint8 Char)
+{
+	return (Char >= 'a' && Char <= 'z') || IsNumberChar(Char);
+}
+
+int32 HexToInt(uint8 Char)
+{
+	if (Char >= '0' && Char <= '9')
+		return Char - '0';
+	if (Char >= 'a' && Char <= 'f')
+		return Char - 'a' + 10;
+	if (Char >= 'A' && Char <= 'F')
+		return Char - 'A' + 10;
+	return -1;
+}
+
+void AppendUtf8(TArray<ANSICHAR>& Out, uint32 CodePoint)
+{
+	if (CodePoint < 0x80)
+	{
+		Out.Add(static_cast<ANSICHAR>(CodePoint));
+	}
+	else if (CodePoint < 0x800)
+	{
+		Out.Add(static_cast<ANSICHAR>(0xC0 | (CodePoint >> 6)));
+		Out.Add(static_cast<ANSICHAR>(0x80 | (CodePoint & 0x3F)));
+	}
+	else if (CodePoint < 0x10000)
+	{
+		Out.Add(static_cast<ANSICHAR>(0xE0 | (CodePoint >> 12)));
+		Out.Add(static_cast<ANSICHAR>(0x80 | ((CodePoint >> 6) & 0x3F)));
+		Out.Add(static_cast<ANSICHAR>(0x80 | (CodePoint & 0x3F)));
+	}
+	else
+	{
+		Out.Add(static_cast<ANSICHAR>(0xF0 | (CodePoint >> 18)));
+		Out.Add(static_cast<ANSICHAR>(0x80 | ((CodePoint >> 12) & 0x3F)));
+		Out.Add(static_cast<ANSICHAR>(0x80 | ((CodePoint >> 6) & 0x3F)));
+		Out.Add(static_cast<ANSICHAR>(0x80 | (CodePoint & 0x3F)));
+	}
+}
+
+void Utf8ToString(const ANSICHAR* Source, int32 SourceLen, FString& OutString)
+{
+	if (SourceLen == 0)
+	{
+		OutString.Reset();
+		return;
+	}
+
+	const FUTF8ToTCHAR Converted(Source, SourceLen);
+	OutString = FString(Converted.Length(), Converted.Get());
+}
+}
+
+bool FGridlyRecordsParser::Parse(const TArray<uint8>& Content, TArray<FGridlyTableRow>& OutTableRows)
+{
+	return Parse(Content.GetData(), Content.Num(), OutTableRows);
+}
+
+bool FGridlyRecordsParser::Parse(const uint8* Data, int64 Size, TArray<FGridlyTableRow>& OutTableRows)
+{
+	FGridlyRecordsParser Parser(Data, Size);
+	return Parser.ParseRecords(OutTableRows);
+}
+
+FGridlyRecordsParser::FGridlyRecordsParser(const uint8* Data, int64 Size) :
+	Data(Data),
+	Current(Data),
+	End(Data + Size)
+{
+	// Skip the byte order mark, if any
+
+	if (Size >= 3 && Data[0] == 0xEF && Data[1] == 0xBB && Data[2] == 0xBF)
+	{
+		Current += 3;
+	}
+}
+
+bool FGridlyRecordsParser::ParseRecords(TArray<FGridlyTableRow>& OutTableRows)
+{
+	SkipWhitespace();
+	if (!Consume('['))
+	{
+		return Fail(TEXT("expected an array of records"));
+	}
+
+	SkipWhitespace();
+	if (Consume(']'))
+	{
+		return true;
+	}
+
+	do
+	{
+		SkipWhitespace();
+		if (!ParseRecord(OutTableRows.AddDefaulted_GetRef()))
+		{
+			return false;
+		}
+		SkipWhitespace();
+	}
+	while (Consume(','));
+
+	if (!Consume(']'))
+	{
+		return Fail(TEXT("expected ',' or ']' after record"));
+	}
+
+	return true;
+}
+
+bool FGridlyRecordsParser::ParseRecord(FGridlyTableRow& OutTableRow)
+{
+	if (!Consume('{'))
+	{
+		return Fail(TEXT("expected a record object"));
+	}
+
+	SkipWhitespace();
+	if (Consume('}'))
+	{
+		return true;
+	}
+
+	do
+	{
+		const ANSICHAR* Key;
+		int32 KeyLen;
+		if (!ParseKey(Key, KeyLen))
+		{
+			return false;
+		}
+
+		bool bParsed;
+		if (KeyEquals(Key, KeyLen, "id"))
+		{
+			bParsed = ParseValueAsString(OutTableRow.Id);
+		}
+		else if (KeyEquals(Key, KeyLen, "path"))
+		{
+			bParsed = ParseValueAsString(OutTableRow.Path);
+		}
+		else if (KeyEquals(Key, KeyLen, "cells") && Current < End && *Current == '[')
+		{
+			bParsed = ParseCells(OutTableRow.Cells);
+		}
+		else
+		{
+			bParsed = SkipValue();
+		}
+
+		if (!bParsed)
+		{
+			return false;
+		}
+
+		SkipWhitespace();
+	}
+	while (Consume(','));
+
+	if (!Consume('}'))
+	{
+		return Fail(TEXT("expected ',' or '}' in record"));
+	}
+
+	return true;
+}
+
+bool FGridlyRecordsParser::ParseCells(TArray<FGridlyTableCell>& OutCells)
+{
+	Consume('[');
+
+	SkipWhitespace();
+	if (Consume(']'))
+	{
+		return true;
+	}
+
+	do
+	{
+		SkipWhitespace();
+		if (!ParseCell(OutCells.AddDefaulted_GetRef()))
+		{
+			return false;
+		}
+		SkipWhitespace();
+	}
+	while (Consume(','));
+
+	if (!Consume(']'))
+	{
+		return Fail(TEXT("expected ',' or ']' after cell"));
+	}
+
+	return true;
+}
+
+bool FGridlyRecordsParser::ParseCell(FGridlyTableCell& OutCell)
+{
+	if (!Consume('{'))
+	{
+		return Fail(TEXT("expected a cell object"));
+	}
+
+	SkipWhitespace();
+	if (Consume('}'))
+	{
+		return true;
+	}
+
+	do
+	{
+		const ANSICHAR* Key;
+		int32 KeyLen;
+		if (!ParseKey(Key, KeyLen))
+		{
+			return false;
+		}
+
+		bool bParsed;
+		if (KeyEquals(Key, KeyLen, "columnId"))
+		{
+			bParsed = ParseValueAsString(OutCell.ColumnId);
+		}
+		else if (KeyEquals(Key, KeyLen, "dependencyStatus"))
+		{
+			bParsed = ParseValueAsString(OutCell.DependencyStatus);
+		}
+		else if (KeyEquals(Key, KeyLen, "value"))
+		{
+			bParsed = ParseValueAsString(OutCell.Value);
+		}
+		else
+		{
+			bParsed = SkipValue();
+		}
+
+		if (!bParsed)
+		{
+			return false;
+		}
+
+		SkipWhitespace();
+	}
+	while (Consume(','));
+
+	if (!Consume('}'))
+	{
+		return Fail(TEXT("expected ',' or '}' in cell"));
+	}
+
+	return true;
+}
+
+bool FGridlyRecordsParser::ParseValueAsString(FString& OutString)
+{
+	SkipWhitespace();
+	if (Current >= End)
+	{
+		return Fail(TEXT("unexpected end of content"));
+	}
+
+	if (*Current == '"')
+	{
+		return ParseString(OutString);
+	}
+
+	if (*Current == '{' || *Current == '[')
+	{
+		OutString.Reset();
+		return SkipValue();
+	}
+
+	// Numbers and literals are kept as written, except null
+
+	const uint8* Start = Current;
+	while (Current < End && GridlyRecordsParser::IsLiteralChar(*Current))
+	{
+		Current++;
+	}
+
+	const int32 Len = Current - Start;
+	if (Len == 0)
+	{
+		return Fail(TEXT("unexpected character"));
+	}
+
+	if (KeyEquals(reinterpret_cast<const ANSICHAR*>(Start), Len, "null"))
+	{
+		OutString.Reset();
+	}
+	else
+	{
+		GridlyRecordsParser::Utf8ToString(reinterpret_cast<const ANSICHAR*>(Start), Len, OutString);
+	}
+
+	return true;
+}
+
+bool FGridlyRecordsParser::ParseString(FString& OutString)
+{
+	Consume('"');
+
+	// Most strings have no escape sequences and are converted straight from the content
+
+	const uint8* Start = Current;
+	while (Current < End && *Current != '"' && *Current != '\\')
+	{
+		Current++;
+	}
+
+	if (Current >= End)
+	{
+		return Fail(TEXT("unterminated string"));
+	}
+
+	if (*Current == '"')
+	{
+		GridlyRecordsParser::Utf8ToString(reinterpret_cast<const ANSICHAR*>(Start), Current - Start, OutString);
+		Current++;
+		return true;
+	}
+
+	Unescaped.Reset();
+	Unescaped.Append(reinterpret_cast<const ANSICHAR*>(Start), Current - Start);
+
+	while (Current < End && *Current != '"')
+	{
+		if (*Current != '\\')
+		{
+			Unescaped.Add(static_cast<ANSICHAR>(*Current++));
+			continue;
+		}
+
+		if (++Current >= End)
+		{
+			break;
+		}
+
+		switch (*Current++)
+		{
+		case '"': Unescaped.Add('"');
+			break;
+		case '\\': Unescaped.Add('\\');
+			break;
+		case '/': Unescaped.Add('/');
+			break;
+		case 'b': Unescaped.Add('\b');
+			break;
+		case 'f': Unescaped.Add('\f');
+			break;
+		case 'n': Unescaped.Add('\n');
+			break;
+		case 'r': Unescaped.Add('\r');
+			break;
+		case 't': Unescaped.Add('\t');
+			break;
+		case 'u':
+		{
+			uint32 CodePoint = 0;
+			for (int i = 0; i < 4; i++)
+			{
+				const int32 Digit = Current < End ? GridlyRecordsParser::HexToInt(*Current++) : -1;
+				if (Digit < 0)
+				{
+					return Fail(TEXT("invalid unicode escape sequence"));
+				}
+				CodePoint = (CodePoint << 4) | Digit;
+			}
+
+			// Combine surrogate pairs, lone surrogates are replaced
+
+			if (CodePoint >= 0xD800 && CodePoint <= 0xDBFF && End - Current >= 6 && Current[0] == '\\' && Current[1] == 'u')
+			{
+				uint32 LowSurrogate = 0;
+				for (int i = 2; i < 6; i++)
+				{
+					const int32 Digit = GridlyRecordsParser::HexToInt(Current[i]);
+					LowSurrogate = Digit < 0 ? 0 : (LowSurrogate << 4) | Digit;
+				}
+
+				if (LowSurrogate >= 0xDC00 && LowSurrogate <= 0xDFFF)
+				{
+					CodePoint = 0x10000 + ((CodePoint - 0xD800) << 10) + (LowSurrogate - 0xDC00);
+					Current += 6;
+				}
+			}
+
+			if (CodePoint >= 0xD800 && CodePoint <= 0xDFFF)
+			{
+				CodePoint = 0xFFFD;
+			}
+
+			GridlyRecordsParser::AppendUtf8(Unescaped, CodePoint);
+			break;
+		}
+		default:
+			return Fail(TEXT("invalid escape sequence"));
+		}
+	}
+
+	if (!Consume('"'))
+	{
+		return Fail(TEXT("unterminated string"));
+	}
+
+	GridlyRecordsParser::Utf8ToString(Unescaped.GetData(), Unescaped.Num(), OutString);
+	return true;
+}
+
+bool FGridlyRecordsParser::ParseKey(const ANSICHAR*& OutKey, int32& OutKeyLen)
+{
+	SkipWhitespace();
+	if (!Consume('"'))
+	{
+		return Fail(TEXT("expected a key"));
+	}
+
+	// The keys we look for never contain escape sequences, so the raw bytes can be compared
+
+	const uint8* Start = Current;
+	if (!SkipString())
+	{
+		return false;
+	}
+
+	OutKey = reinterpret_cast<const ANSICHAR*>(Start);
+	OutKeyLen = Current - 1 - Start;
+
+	SkipWhitespace();
+	if (!Consume(':'))
+	{
+		return Fail(TEXT("expected ':' after key"));
+	}
+
+	SkipWhitespace();
+	return true;
+}
+
+bool FGridlyRecordsParser::SkipValue()
+{
+	SkipWhitespace();
+	if (Current >= End)
+	{
+		return Fail(TEXT("unexpected end of content"));
+	}
+
+	if (*Current == '"')
+	{
+		Current++;
+		return SkipString();
+	}
+
+	if (*Current != '{' && *Current != '[')
+	{
+		const uint8* Start = Current;
+		while (Current < End && GridlyRecordsParser::IsLiteralChar(*Current))
+		{
+			Current++;
+		}
+		return Current > Start || Fail(TEXT("unexpected character"));
+	}
+
+	int32 Depth = 0;
+	while (Current < End)
+	{
+		const uint8 Char = *Current++;
+		if (Char == '"')
+		{
+			if (!SkipString())
+			{
+				return false;
+			}
+		}
+		else if (Char == '{' || Char == '[')
+		{
+			Depth++;
+		}
+		else if ((Char == '}' || Char == ']') && --Depth == 0)
+		{
+			return true;
+		}
+	}
+
+	return Fail(TEXT("unexpected end of content"));
+}
+
+bool FGridlyRecordsParser::SkipString()
+{
+	// Expects the opening quote to have been consumed, leaves the cursor after the closing quote
+
+	while (Current < End)
+	{
+		const uint8 Char = *Current++;
+		if (Char == '"')
+		{
+			return true;
+		}
+		if (Char == '\\')
+		{
+			Current++;
+		}
+	}
+
+	return Fail(TEXT("unterminated string"));
+}
+
+void FGridlyRecordsParser::SkipWhitespace()
+{
+	while (Current < End && (*Current == ' ' || *Current == '\n' || *Current == '\r' || *Current == '\t'))
+	{
+		Current++;
+	}
+}
+
+bool FGridlyRecordsParser::Consume(ANSICHAR Char)
+{
+	if (Current < End && *Current == static_cast<uint8>(Char))
+	{
+		Current++;
+		return true;
+	}
+
+	return false;
+}
+
+bool FGridlyRecordsParser::Fail(const TCHAR* Message)
+{
+	UE_LOG(LogGridly, Error, TEXT("Failed to parse records at byte %lld: %s"), static_cast<int64>(Current - Data), Message);
+	return false;
+}
+
+bool FGridlyRecordsParser::KeyEquals(const ANSICHAR* Key, int32 KeyLen, const ANSICHAR* Expected)
+{
+	return FCStringAnsi::Strlen(Expected) == KeyLen && FCStringAnsi::Strnicmp(Key, Expected, KeyLen) == 0;
+}
+
+#if !UE_BUILD_SHIPPING
+
+namespace GridlyRecordsParser
+{
+bool AreRowsEqual(const TArray<FGridlyTableRow>& A, const TArray<FGridlyTableRow>& B)
+{
+	if (A.Num() != B.Num())
+		return false;
+
+	for (int i = 0; i < A.Num(); i++)
+	{
+		if (A[i].Id != B[i].Id || A[i].Path != B[i].Path || A[i].Cells.Num() != B[i].Cells.Num())
+			return false;
+
+		for (int j = 0; j < A[i].Cells.Num(); j++)
+		{
+			const FGridlyTableCell& CellA = A[i].Cells[j];
+			const FGridlyTableCell& CellB = B[i].Cells[j];
+			if (CellA.ColumnId != CellB.ColumnId || CellA.DependencyStatus != CellB.DependencyStatus || CellA.Value != CellB.Value)
+				return false;
+		}
+	}
+
+	return true;
+}
+
+void BenchmarkRecordsParser(const TArray<FString>& Args)
+{
+	if (Args.Num() < 1)
+	{
+		UE_LOG(LogGridly, Display, TEXT("Usage: Gridly.BenchmarkRecordsParser <ResponseFile> [Iterations]"));
+		return;
+	}
+
+	TArray<uint8> Content;
+	if (!FFileHelper::LoadFileToArray(Content, *Args[0]))
+	{
+		UE_LOG(LogGridly, Error, TEXT("Could not read %s"), *Args[0]);
+		return;
+	}
+
+	const int Iterations = Args.Num() > 1 ? FMath::Max(1, FCString::Atoi(*Args[1])) : 10;
+	const double ContentMegabytes = Content.Num() / (1024.0 * 1024.0);
+
+	// The memory figures are the increase in used physical memory during one parse, with the result still alive. They are
+	// only indicative, as the allocator may reuse memory it already holds
+
+	auto Measure = [&](const TCHAR* Name, TFunctionRef<bool(TArray<FGridlyTableRow>&)> ParseFunction,
+		TArray<FGridlyTableRow>& OutTableRows)
+	{
+		const uint64 UsedMemoryBefore = FPlatformMemory::GetStats().UsedPhysical;
+		if (!ParseFunction(OutTableRows))
+		{
+			UE_LOG(LogGridly, Error, TEXT("%s: failed to parse %s"), Name, *Args[0]);
+			return;
+		}
+		const int64 UsedMemoryDelta = static_cast<int64>(FPlatformMemory::GetStats().UsedPhysical) - UsedMemoryBefore;
+
+		const double StartTime = FPlatformTime::Seconds();
+		for (int i = 0; i < Iterations; i++)
+		{
+			TArray<FGridlyTableRow> TableRows;
+			ParseFunction(TableRows);
+		}
+		const double Seconds = (FPlatformTime::Seconds() - StartTime) / Iterations;
+
+		UE_LOG(LogGridly, Display, TEXT("%s: %d rows, %.3f ms per parse, %.1f MB/s, ~%lld KB used"), Name, OutTableRows.Num(),
+			Seconds * 1000.0, ContentMegabytes / FMath::Max(Seconds, SMALL_NUMBER), UsedMemoryDelta / 1024);
+	};
+
+	TArray<FGridlyTableRow> ConverterTableRows;
+	Measure(TEXT("FJsonObjectConverter"), [&Content](TArray<FGridlyTableRow>& OutTableRows)
+	{
+		// Same conversion as IHttpResponse::GetContentAsString
+
+		const FUTF8ToTCHAR Converted(reinterpret_cast<const ANSICHAR*>(Content.GetData()), Content.Num());
+		const FString ContentString(Converted.Length(), Converted.Get());
+		return FJsonObjectConverter::JsonArrayStringToUStruct(ContentString, &OutTableRows, 0, 0);
+	}, ConverterTableRows);
+
+	TArray<FGridlyTableRow> ParserTableRows;
+	Measure(TEXT("FGridlyRecordsParser"), [&Content](TArray<FGridlyTableRow>& OutTableRows)
+	{
+		return FGridlyRecordsParser::Parse(Content, OutTableRows);
+	}, ParserTableRows);
+
+	UE_LOG(LogGridly, Display, TEXT("Results %s"),
+		AreRowsEqual(ConverterTableRows, ParserTableRows) ? TEXT("match") : TEXT("DIFFER (non-string values are expected to)"));
+}
+
+FAutoConsoleCommand BenchmarkRecordsParserCommand(
+	TEXT("Gridly.BenchmarkRecordsParser"),
+	TEXT("Compares parsing a saved records response with FGridlyRecordsParser and FJsonObjectConverter"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkRecordsParser));
+}
+
+#endif
@@ -0,0 +1,48 @@
+﻿// Copyright (c) 2021 LocalizeDirect AB
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "GridlyTableRow.h"
+
+/**
+ * Parses the response of the records endpoint straight from its UTF-8 bytes into table rows, without widening the payload
+ * to TCHAR or building a JSON DOM first. Accepts the same input as FJsonObjectConverter::JsonArrayStringToUStruct does
+ * for FGridlyTableRow: keys are matched case-insensitively, unknown keys are skipped, and non-string cell values are kept
+ * as their JSON text (null, arrays and objects become empty strings).
+ */
+class GRIDLY_API FGridlyRecordsParser
+{
+public:
+	static bool Parse(const TArray<uint8>& Content, TArray<FGridlyTableRow>& OutTableRows);
+	static bool Parse(const uint8* Data, int64 Size, TArray<FGridlyTableRow>& OutTableRows);
+
+private:
+	FGridlyRecordsParser(const uint8* Data, int64 Size);
+
+	bool ParseRecords(TArray<FGridlyTableRow>& OutTableRows);
+	bool ParseRecord(FGridlyTableRow& OutTableRow);
+	bool ParseCells(TArray<FGridlyTableCell>& OutCells);
+	bool ParseCell(FGridlyTableCell& OutCell);
+
+	/** Parses any value into a string the way FJsonObjectConverter would assign it to an FString property */
+	bool ParseValueAsString(FString& OutString);
+	bool ParseString(FString& OutString);
+	bool ParseKey(const ANSICHAR*& OutKey, int32& OutKeyLen);
+	bool SkipValue();
+	bool SkipString();
+
+	void SkipWhitespace();
+	bool Consume(ANSICHAR Char);
+	bool Fail(const TCHAR* Message);
+
+	static bool KeyEquals(const ANSICHAR* Key, int32 KeyLen, const ANSICHAR* Expected);
+
+	const uint8* Data;
+	const uint8* Current;
+	const uint8* End;
+
+	// Scratch buffer for strings that contain escape sequences
+	TArray<ANSICHAR> Unescaped;
+};
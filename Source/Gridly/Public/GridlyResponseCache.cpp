@@ -0,0 +1,384 @@
+﻿// Copyright (c) 2021 LocalizeDirect AB
+
+#include "GridlyResponseCache.h"
+
+#include "Gridly.h"
+#include "GridlyGameSettings.h"
+#include "GridlyHttpCompression.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/SecureHash.h"
+#include "Algo/Sort.h"
+#include "Serialization/LargeMemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace GridlyResponseCache
+{
+constexpr uint32 FileMagic = 0x43524447;	// "GDRC"
+constexpr int32 FileVersion = 1;
+
+struct FEntry
+{
+	FString ETag;
+	FString LastModified;
+	TArray<FString> Headers;
+};
+
+FArchive& operator<<(FArchive& Ar, FEntry& Entry)
+{
+	Ar << Entry.ETag;
+	Ar << Entry.LastModified;
+	Ar << Entry.Headers;
+	return Ar;
+}
+
+/**
+ * Reads an entry from a memory mapped file, falling back to a regular read on platforms that can not map files. When OutContent
+ * is given, the body is inflated straight from the mapped pages.
+ */
+bool ReadEntry(const FString& CacheKey, FEntry& OutEntry, TArray<uint8>* OutContent)
+{
+	const FString FilePath = FGridlyResponseCache::GetFilePath(CacheKey);
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	if (!PlatformFile.FileExists(*FilePath))
+	{
+		return false;
+	}
+
+	TUniquePtr<IMappedFileHandle> MappedFile(PlatformFile.OpenMapped(*FilePath));
+	TUniquePtr<IMappedFileRegion> MappedRegion(MappedFile ? MappedFile->MapRegion() : nullptr);
+
+	TArray<uint8> FileData;
+	const uint8* Data = nullptr;
+	int64 Size = 0;
+
+	if (MappedRegion)
+	{
+		Data = MappedRegion->GetMappedPtr();
+		Size = MappedRegion->GetMappedSize();
+	}
+	else if (FFileHelper::LoadFileToArray(FileData, *FilePath, FILEREAD_Silent))
+	{
+		Data = FileData.GetData();
+		Size = FileData.Num();
+	}
+	else
+	{
+		return false;
+	}
+
+	FLargeMemoryReader Reader(Data, Size);
+
+	uint32 Magic = 0;
+	int32 Version = 0;
+	Reader << Magic;
+	Reader << Version;
+
+	if (Reader.IsError() || Magic != FileMagic || Version != FileVersion)
+	{
+		return false;
+	}
+
+	Reader << OutEntry;
+
+	if (Reader.IsError())
+	{
+		return false;
+	}
+
+	if (OutContent)
+	{
+		const int64 ContentOffset = Reader.Tell();
+		if (!FGridlyHttpCompression::Decompress(Data + ContentOffset, Size - ContentOffset, *OutContent))
+		{
+			UE_LOG(LogGridly, Warning, TEXT("Failed to decompress cached response %s"), *FilePath);
+			return false;
+		}
+	}
+
+	return true;
+}
+}
+
+// Looks exactly like the 200 response that was stored, so callers do not have to tell the two apart
+class FGridlyCachedHttpResponse : public IHttpResponse
+{
+public:
+	FGridlyCachedHttpResponse(const FString& InUrl, TArray<FString>&& InHeaders, TArray<uint8>&& InContent) :
+		Url(InUrl),
+		Headers(MoveTemp(InHeaders)),
+		Content(MoveTemp(InContent))
+	{
+	}
+
+	virtual FString GetURL() const override
+	{
+		return Url;
+	}
+
+	virtual FString GetURLParameter(const FString& ParameterName) const override
+	{
+		return FString();
+	}
+
+	virtual FString GetHeader(const FString& HeaderName) const override
+	{
+		for (const FString& Header : Headers)
+		{
+			FString Name;
+			FString Value;
+			if (Header.Split(TEXT(":"), &Name, &Value) && Name.TrimStartAndEnd().Equals(HeaderName, ESearchCase::IgnoreCase))
+			{
+				return Value.TrimStartAndEnd();
+			}
+		}
+
+		return FString();
+	}
+
+	virtual TArray<FString> GetAllHeaders() const override
+	{
+		return Headers;
+	}
+
+	virtual FString GetContentType() const override
+	{
+		return GetHeader(TEXT("Content-Type"));
+	}
+
+	virtual int32 GetContentLength() const override
+	{
+		return Content.Num();
+	}
+
+	virtual const TArray<uint8>& GetContent() const override
+	{
+		return Content;
+	}
+
+	virtual int32 GetResponseCode() const override
+	{
+		return EHttpResponseCodes::Ok;
+	}
+
+	virtual FString GetContentAsString() const override
+	{
+		const FUTF8ToTCHAR Converted(reinterpret_cast<const ANSICHAR*>(Content.GetData()), Content.Num());
+		return FString(Converted.Length(), Converted.Get());
+	}
+
+private:
+	FString Url;
+	TArray<FString> Headers;
+	TArray<uint8> Content;
+};
+
+bool FGridlyResponseCache::IsEnabled()
+{
+	return GetMutableDefault<UGridlyGameSettings>()->bUseResponseCache;
+}
+
+bool FGridlyResponseCache::IsCacheable(const FString& Url)
+{
+	FString Query;
+	if (!Url.Split(TEXT("?"), nullptr, &Query))
+	{
+		return true;
+	}
+
+	TArray<FString> Parameters;
+	Query.ParseIntoArray(Parameters, TEXT("&"));
+
+	return !Parameters.ContainsByPredicate([](const FString& Parameter)
+	{
+		return Parameter.StartsWith(TEXT("query="));
+	});
+}
+
+bool FGridlyResponseCache::AddValidators(const FString& CacheKey, IHttpRequest& HttpRequest)
+{
+	GridlyResponseCache::FEntry Entry;
+	if (!GridlyResponseCache::ReadEntry(CacheKey, Entry, nullptr))
+	{
+		return false;
+	}
+
+	if (!Entry.ETag.IsEmpty())
+	{
+		HttpRequest.SetHeader(TEXT("If-None-Match"), Entry.ETag);
+	}
+
+	if (!Entry.LastModified.IsEmpty())
+	{
+		HttpRequest.SetHeader(TEXT("If-Modified-Since"), Entry.LastModified);
+	}
+
+	return true;
+}
+
+bool FGridlyResponseCache::Store(const FString& CacheKey, const FHttpResponsePtr& HttpResponsePtr)
+{
+	GridlyResponseCache::FEntry Entry;
+	Entry.ETag = HttpResponsePtr->GetHeader(TEXT("ETag"));
+	Entry.LastModified = HttpResponsePtr->GetHeader(TEXT("Last-Modified"));
+
+	// Without a validator the entry could never be revalidated
+
+	if (Entry.ETag.IsEmpty() && Entry.LastModified.IsEmpty())
+	{
+		return false;
+	}
+
+	// The body is stored decoded by the cache, so its encoding and length no longer apply
+
+	for (const FString& Header : HttpResponsePtr->GetAllHeaders())
+	{
+		FString Name;
+		if (Header.Split(TEXT(":"), &Name, nullptr))
+		{
+			Name.TrimStartAndEndInline();
+			if (Name.Equals(TEXT("Content-Encoding"), ESearchCase::IgnoreCase)
+			    || Name.Equals(TEXT("Content-Length"), ESearchCase::IgnoreCase))
+			{
+				continue;
+			}
+		}
+
+		Entry.Headers.Add(Header);
+	}
+
+	TArray<uint8> FileData;
+	FMemoryWriter Writer(FileData);
+
+	uint32 Magic = GridlyResponseCache::FileMagic;
+	int32 Version = GridlyResponseCache::FileVersion;
+	Writer << Magic;
+	Writer << Version;
+	Writer << Entry;
+
+	// Pages that still arrive gzipped are stored as they are, anything else is compressed first
+
+	const TArray<uint8>& Content = HttpResponsePtr->GetContent();
+	if (FGridlyHttpCompression::IsCompressed(Content))
+	{
+		FileData.Append(Content);
+	}
+	else
+	{
+		TArray<uint8> CompressedContent;
+		if (!FGridlyHttpCompression::Compress(Content.GetData(), Content.Num(), CompressedContent))
+		{
+			return false;
+		}
+
+		FileData.Append(CompressedContent);
+	}
+
+	const FString FilePath = GetFilePath(CacheKey);
+	if (!FFileHelper::SaveArrayToFile(FileData, *FilePath))
+	{
+		UE_LOG(LogGridly, Warning, TEXT("Failed to save cached response to %s"), *FilePath);
+		return false;
+	}
+
+	return true;
+}
+
+FHttpResponsePtr FGridlyResponseCache::Load(const FString& CacheKey, const FString& Url)
+{
+	GridlyResponseCache::FEntry Entry;
+	TArray<uint8> Content;
+	if (!GridlyResponseCache::ReadEntry(CacheKey, Entry, &Content))
+	{
+		return nullptr;
+	}
+
+	// Pruning goes by modification time, so an entry that is still in use is kept
+
+	IFileManager::Get().SetTimeStamp(*GetFilePath(CacheKey), FDateTime::UtcNow());
+
+	return MakeShared<FGridlyCachedHttpResponse, ESPMode::ThreadSafe>(Url, MoveTemp(Entry.Headers), MoveTemp(Content));
+}
+
+void FGridlyResponseCache::Remove(const FString& CacheKey)
+{
+	IFileManager::Get().Delete(*GetFilePath(CacheKey), false, false, true);
+}
+
+void FGridlyResponseCache::Prune()
+{
+	const UGridlyGameSettings* GameSettings = GetMutableDefault<UGridlyGameSettings>();
+	const FString CacheDir = FPaths::ProjectSavedDir() / TEXT("Gridly") / TEXT("Cache");
+
+	IFileManager& FileManager = IFileManager::Get();
+	if (!FileManager.DirectoryExists(*CacheDir))
+	{
+		return;
+	}
+
+	struct FCacheFile
+	{
+		FString FilePath;
+		FDateTime ModificationTime;
+		int64 Size;
+	};
+
+	TArray<FCacheFile> CacheFiles;
+	FileManager.IterateDirectoryStat(*CacheDir, [&CacheFiles](const TCHAR* FilenameOrDirectory, const FFileStatData& StatData)
+	{
+		if (!StatData.bIsDirectory && FPaths::GetExtension(FilenameOrDirectory) == TEXT("bin"))
+		{
+			CacheFiles.Add({FilenameOrDirectory, StatData.ModificationTime, StatData.FileSize});
+		}
+		return true;
+	});
+
+	// Least recently used first
+
+	Algo::SortBy(CacheFiles, &FCacheFile::ModificationTime);
+
+	int64 TotalSize = 0;
+	for (const FCacheFile& CacheFile : CacheFiles)
+	{
+		TotalSize += CacheFile.Size;
+	}
+
+	const FDateTime MinModificationTime = FDateTime::UtcNow() - FTimespan::FromDays(GameSettings->ResponseCacheMaxAgeDays);
+	const int64 MaxSize = static_cast<int64>(GameSettings->ResponseCacheMaxSizeMB) * 1024 * 1024;
+
+	int32 NumRemoved = 0;
+	for (const FCacheFile& CacheFile : CacheFiles)
+	{
+		if (CacheFile.ModificationTime >= MinModificationTime && TotalSize <= MaxSize)
+		{
+			break;
+		}
+
+		if (FileManager.Delete(*CacheFile.FilePath, false, false, true))
+		{
+			TotalSize -= CacheFile.Size;
+			NumRemoved++;
+		}
+	}
+
+	if (NumRemoved > 0)
+	{
+		UE_LOG(LogGridly, Log, TEXT("Pruned %d of %d cached responses from %s"), NumRemoved, CacheFiles.Num(), *CacheDir);
+	}
+}
+
+FString FGridlyResponseCache::GetFilePath(const FString& CacheKey)
+{
+	// The key holds the API key, so only its hash ends up on disk
+
+	const FTCHARToUTF8 KeyUtf8(*CacheKey);
+
+	FSHAHash Hash;
+	FSHA1::HashBuffer(KeyUtf8.Get(), KeyUtf8.Length(), Hash.Hash);
+
+	return FPaths::ProjectSavedDir() / TEXT("Gridly") / TEXT("Cache") / (Hash.ToString() + TEXT(".bin"));
+}
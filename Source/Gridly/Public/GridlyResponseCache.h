@@ -0,0 +1,39 @@
+﻿// Copyright (c) 2021 LocalizeDirect AB
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Interfaces/IHttpRequest.h"
+#include "Interfaces/IHttpResponse.h"
+
+/**
+ * Downloaded view pages persisted under Saved/Gridly/Cache, one file per request named after a hash of its URL (view ID, page
+ * and columns) and API key. Each entry keeps the gzipped body along with the ETag and Last-Modified validators, which are sent
+ * back on the next identical request so Gridly can answer with 304 Not Modified instead of the whole page. Entries that have not
+ * been used for a while, or the oldest ones once the cache grows past its size limit, are pruned when the module starts.
+ */
+class GRIDLY_API FGridlyResponseCache
+{
+public:
+	static bool IsEnabled();
+
+	/** Requests with a query are not cached, since their URL changes with every sync and the entry would never be used again */
+	static bool IsCacheable(const FString& Url);
+
+	/** Adds If-None-Match and If-Modified-Since for a cached entry. Returns false if there is none */
+	static bool AddValidators(const FString& CacheKey, IHttpRequest& HttpRequest);
+
+	/** Stores a 200 response, as long as Gridly sent a validator for it */
+	static bool Store(const FString& CacheKey, const FHttpResponsePtr& HttpResponsePtr);
+
+	/** Loads a cached entry as a 200 response with its original headers, e.g. after a 304 Not Modified */
+	static FHttpResponsePtr Load(const FString& CacheKey, const FString& Url);
+
+	static void Remove(const FString& CacheKey);
+
+	/** Deletes entries older than the configured age, then the least recently used ones until the cache fits its size limit */
+	static void Prune();
+
+	static FString GetFilePath(const FString& CacheKey);
+};
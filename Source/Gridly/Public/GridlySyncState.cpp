@@ -0,0 +1,193 @@
+﻿// Copyright (c) 2021 LocalizeDirect AB
+
+#include "GridlySyncState.h"
+
+#include "Gridly.h"
+#include "GridlyGameSettings.h"
+#include "JsonObjectConverter.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace GridlySyncState
+{
+// Records changed slightly before the last sync are requested again, to make up for clock differences with the server
+const FTimespan QueryTimeMargin = FTimespan::FromMinutes(5.0);
+
+uint32 HashString(const FString& String, uint32 Crc)
+{
+	const int32 Len = String.Len();
+	Crc = FCrc::MemCrc32(&Len, sizeof(Len), Crc);
+	return FCrc::StrCrc32(*String, Crc);
+}
+}
+
+void FGridlySyncState::Load(const FString& InScope, const FString& InViewId, const TArray<FString>& InColumnIds)
+{
+	const UGridlyGameSettings* GameSettings = GetMutableDefault<UGridlyGameSettings>();
+
+	*this = FGridlySyncState();
+	Scope = InScope;
+	SyncStartTime = FDateTime::UtcNow();
+
+	FString JsonString;
+	FGridlySyncState LoadedState;
+	if (FFileHelper::LoadFileToString(JsonString, *GetFilePath(Scope, InViewId))
+	    && FJsonObjectConverter::JsonObjectStringToUStruct(JsonString, &LoadedState, 0, 0))
+	{
+		if (LoadedState.ViewId == InViewId && LoadedState.Query == GameSettings->IncrementalImportQuery
+		    && LoadedState.ColumnIds == InColumnIds)
+		{
+			Query = LoadedState.Query;
+			LastSyncTime = LoadedState.LastSyncTime;
+			LastFullSyncTime = LoadedState.LastFullSyncTime;
+			Records = MoveTemp(LoadedState.Records);
+		}
+		else
+		{
+			UE_LOG(LogGridly, Log, TEXT("Sync state of view ID %s is out of date, doing a full import"), *InViewId);
+		}
+	}
+
+	ViewId = InViewId;
+	ColumnIds = InColumnIds;
+	RebuildIndex();
+
+	const FTimespan FullSyncInterval = FTimespan::FromHours(GameSettings->IncrementalImportFullSyncHours);
+	const bool bFullSyncDue = GameSettings->IncrementalImportFullSyncHours > 0
+	                          && SyncStartTime - LastFullSyncTime > FullSyncInterval;
+
+	bFullSync = GameSettings->IncrementalImportQuery.IsEmpty() || Records.Num() == 0 || LastSyncTime.GetTicks() == 0
+	            || bFullSyncDue;
+}
+
+bool FGridlySyncState::Save()
+{
+	FString JsonString;
+	if (!FJsonObjectConverter::UStructToJsonObjectString(*this, JsonString, 0, 0, 0, nullptr, false))
+	{
+		return false;
+	}
+
+	const FString FilePath = GetFilePath(Scope, ViewId);
+	if (!FFileHelper::SaveStringToFile(JsonString, *FilePath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+	{
+		UE_LOG(LogGridly, Warning, TEXT("Failed to save sync state to %s"), *FilePath);
+		return false;
+	}
+
+	return true;
+}
+
+bool FGridlySyncState::GetChangedRecordsQuery(FString& OutQuery) const
+{
+	if (bFullSync)
+	{
+		return false;
+	}
+
+	const UGridlyGameSettings* GameSettings = GetMutableDefault<UGridlyGameSettings>();
+	OutQuery = GameSettings->IncrementalImportQuery.Replace(TEXT("{LastSyncTime}"),
+		*(LastSyncTime - GridlySyncState::QueryTimeMargin).ToIso8601());
+	return true;
+}
+
+int FGridlySyncState::MergeRows(const TArray<FGridlyTableRow>& TableRows)
+{
+	int ChangedRows = 0;
+
+	for (const FGridlyTableRow& TableRow : TableRows)
+	{
+		SeenRecordIds.Add(TableRow.Id);
+
+		const uint32 Hash = HashRow(TableRow);
+		if (const int* RecordIndex = RecordIndices.Find(TableRow.Id))
+		{
+			FGridlySyncRecord& Record = Records[*RecordIndex];
+			if (Record.Hash != Hash)
+			{
+				Record.Hash = Hash;
+				Record.Row = TableRow;
+				ChangedRows++;
+			}
+		}
+		else
+		{
+			RecordIndices.Add(TableRow.Id, Records.Num());
+			FGridlySyncRecord& Record = Records.AddDefaulted_GetRef();
+			Record.Hash = Hash;
+			Record.Row = TableRow;
+			ChangedRows++;
+		}
+	}
+
+	return ChangedRows;
+}
+
+void FGridlySyncState::Finish()
+{
+	if (bFullSync)
+	{
+		// Anything that was not downloaded has been deleted in Gridly
+
+		const int RemovedRecords = Records.RemoveAll([this](const FGridlySyncRecord& Record)
+		{
+			return !SeenRecordIds.Contains(Record.Row.Id);
+		});
+
+		if (RemovedRecords > 0)
+		{
+			UE_LOG(LogGridly, Log, TEXT("Removed %d records deleted from view ID %s"), RemovedRecords, *ViewId);
+			RebuildIndex();
+		}
+
+		LastFullSyncTime = SyncStartTime;
+	}
+
+	const UGridlyGameSettings* GameSettings = GetMutableDefault<UGridlyGameSettings>();
+	Query = GameSettings->IncrementalImportQuery;
+	LastSyncTime = SyncStartTime;
+	SeenRecordIds.Reset();
+}
+
+void FGridlySyncState::GetRows(TArray<FGridlyTableRow>& OutTableRows) const
+{
+	OutTableRows.Reserve(OutTableRows.Num() + Records.Num());
+	for (const FGridlySyncRecord& Record : Records)
+	{
+		OutTableRows.Add(Record.Row);
+	}
+}
+
+int FGridlySyncState::Num() const
+{
+	return Records.Num();
+}
+
+uint32 FGridlySyncState::HashRow(const FGridlyTableRow& TableRow)
+{
+	uint32 Crc = GridlySyncState::HashString(TableRow.Id, 0);
+	Crc = GridlySyncState::HashString(TableRow.Path, Crc);
+
+	for (const FGridlyTableCell& Cell : TableRow.Cells)
+	{
+		Crc = GridlySyncState::HashString(Cell.ColumnId, Crc);
+		Crc = GridlySyncState::HashString(Cell.DependencyStatus, Crc);
+		Crc = GridlySyncState::HashString(Cell.Value, Crc);
+	}
+
+	return Crc;
+}
+
+FString FGridlySyncState::GetFilePath(const FString& Scope, const FString& ViewId)
+{
+	return FPaths::ProjectSavedDir() / TEXT("Gridly") / TEXT("Sync") / Scope / (ViewId + TEXT(".json"));
+}
+
+void FGridlySyncState::RebuildIndex()
+{
+	RecordIndices.Reset();
+	for (int i = 0; i < Records.Num(); i++)
+	{
+		RecordIndices.Add(Records[i].Row.Id, i);
+	}
+}
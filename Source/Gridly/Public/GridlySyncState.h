@@ -0,0 +1,85 @@
+﻿// Copyright (c) 2021 LocalizeDirect AB
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "GridlyTableRow.h"
+
+#include "GridlySyncState.generated.h"
+
+USTRUCT()
+struct GRIDLY_API FGridlySyncRecord
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	uint32 Hash = 0;
+
+	UPROPERTY()
+	FGridlyTableRow Row;
+};
+
+/**
+ * Records of a view as of the last import, persisted under Saved/Gridly/Sync. Incremental imports merge the records they
+ * download into this set instead of starting from scratch.
+ */
+USTRUCT()
+struct GRIDLY_API FGridlySyncState
+{
+	GENERATED_BODY()
+
+public:
+	/** Loads the state of a view, or starts an empty one if there is none or it is no longer usable */
+	void Load(const FString& InScope, const FString& InViewId, const TArray<FString>& InColumnIds);
+
+	bool Save();
+
+	/** Returns true if only changed records have to be requested, in which case OutQuery is the query to send */
+	bool GetChangedRecordsQuery(FString& OutQuery) const;
+
+	/** Merges a page of downloaded records. Returns the amount of records that were added or changed */
+	int MergeRows(const TArray<FGridlyTableRow>& TableRows);
+
+	/** Completes the sync, removing the records that were not part of a full download */
+	void Finish();
+
+	void GetRows(TArray<FGridlyTableRow>& OutTableRows) const;
+
+	int Num() const;
+
+	static uint32 HashRow(const FGridlyTableRow& TableRow);
+
+	static FString GetFilePath(const FString& Scope, const FString& ViewId);
+
+public:
+	UPROPERTY()
+	FString ViewId;
+
+	/** The query the records were synced with, a different query invalidates the state */
+	UPROPERTY()
+	FString Query;
+
+	/** The columns the records were downloaded with, all columns if empty. A different set invalidates the state */
+	UPROPERTY()
+	TArray<FString> ColumnIds;
+
+	UPROPERTY()
+	FDateTime LastSyncTime;
+
+	UPROPERTY()
+	FDateTime LastFullSyncTime;
+
+	UPROPERTY()
+	TArray<FGridlySyncRecord> Records;
+
+private:
+	void RebuildIndex();
+
+	FString Scope;
+	FDateTime SyncStartTime;
+	bool bFullSync = true;
+
+	TMap<FString, int> RecordIndices;
+	TSet<FString> SeenRecordIds;
+};
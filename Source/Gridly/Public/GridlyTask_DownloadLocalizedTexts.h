@@ -2,13 +2,18 @@
 
 #pragma once
 
+#include "GridlyHttpClient.h"
 #include "GridlyResult.h"
+#include "GridlySyncState.h"
+#include "GridlyTableRow.h"
 #include "Interfaces/IHttpRequest.h"
 #include "Internationalization/PolyglotTextData.h"
 #include "Kismet/BlueprintAsyncActionBase.h"
 
 #include "GridlyTask_DownloadLocalizedTexts.generated.h"
 
+class FGridlyColumnSchema;
+
 UDELEGATE()
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FDownloadLocalizedTextsDelegate, const TArray<FPolyglotTextData>&, PolyglotTextDatas,
 	float, Progress, const FGridlyResult&, Error);
@@ -28,7 +33,14 @@ public:
 	virtual void Activate() override;
 
 	void RequestPage(const int ViewIdIndex, const int Offset);
-	void OnProcessRequestComplete(FHttpRequestPtr HttpRequestPtr, FHttpResponsePtr HttpResponsePtr, bool bSuccess);
+	void OnProcessRequestComplete(FHttpRequestPtr HttpRequestPtr, FHttpResponsePtr HttpResponsePtr, bool bSuccess,
+		const FGridlyRequestTiming& Timing, int ViewIdIndex, int PageIndex);
+
+private:
+	void RequestRemainingPages();
+	bool AppendRows(const TArray<FGridlyTableRow>& TableRows);
+	bool FinishView();
+	void Fail(const FGridlyResult& FailResult);
 
 public:
 	UFUNCTION(Category = Gridly, BlueprintCallable, meta = (BlueprintInternalUseOnly = true, WorldContext = "WorldContextObject"))
@@ -48,16 +60,41 @@ public:
 	FDownloadLocalizedTextsProgressDelegate OnProgressDelegate;
 	FDownloadLocalizedTextsFailDelegate OnFailDelegate;;
 
+	EGridlyRequestPriority RequestPriority;
+
+	/** The target cultures to download, every target culture of the project if empty */
+	TArray<FString> Cultures;
+
 private:
-	FHttpRequestPtr HttpRequest;
+	// Pages in flight or queued by the HTTP client
+	TMap<int, FGridlyRequestId> PageRequests;
 	const UObject* WorldContextObject;
 
 	int Limit;
 	int TotalCount;
+	int ReceivedCount;
+	int MaxConcurrentRequests;
+	bool bFailed;
+	float ThrottleTime;
 
 	TArray<FString> ViewIds;
 	int CurrentViewIdIndex;
-	int CurrentOffset;
+	int CurrentViewPageCount;
+	int NextPageIndex;
+	int NextPageToAppend;
+
+	// Pages that completed out of order, waiting for the pages before them
+	TMap<int, TArray<FGridlyTableRow>> CompletedPages;
+
+	bool bUseIncrementalImport;
+	int ChangedCount;
+	FGridlySyncState SyncState;
+
+	// Columns are resolved once for all pages of the import
+	TSharedPtr<FGridlyColumnSchema> ColumnSchema;
+
+	// The columns to download, every column if empty
+	TArray<FString> ColumnIds;
 
 	TArray<FPolyglotTextData> PolyglotTextDatas;
 };
@@ -3,7 +3,9 @@
 #pragma once
 
 #include "GridlyDataTable.h"
+#include "GridlyHttpClient.h"
 #include "GridlyResult.h"
+#include "GridlySyncState.h"
 #include "GridlyTableRow.h"
 #include "Interfaces/IHttpRequest.h"
 #include "Kismet/BlueprintAsyncActionBase.h"
@@ -29,7 +31,8 @@ public:
 	virtual void Activate() override;
 
 	void RequestPage(const int ViewIdIndex, const int Offset);
-	void OnProcessRequestComplete(FHttpRequestPtr HttpRequestPtr, FHttpResponsePtr HttpResponsePtr, bool bSuccess);
+	void OnProcessRequestComplete(FHttpRequestPtr HttpRequestPtr, FHttpResponsePtr HttpResponsePtr, bool bSuccess,
+		const FGridlyRequestTiming& Timing);
 
 public:
 	UFUNCTION(Category = Gridly, BlueprintCallable, meta = (BlueprintInternalUseOnly = true, WorldContext = "WorldContextObject"))
@@ -50,19 +53,29 @@ public:
 	FImportDataTableFromGridlyProgressDelegate OnProgressDelegate;
 	FImportDataTableFromGridlyFailDelegate OnFailDelegate;;
 
+	EGridlyRequestPriority RequestPriority;
+
 private:
-	FHttpRequestPtr HttpRequest;
 	const UObject* WorldContextObject;
 
 	int Limit;
 	int TotalCount;
+	float ThrottleTime;
 
 	TArray<FString> ViewIds;
 	int CurrentViewIdIndex;
+
+	// The columns to download, every column if empty
+	TArray<FString> ColumnIds;
 	int CurrentOffset;
 
 	TArray<FGridlyTableRow> GridlyTableRows;
 
+	bool bUseIncrementalImport;
+	int ReceivedCount;
+	int ChangedCount;
+	FGridlySyncState SyncState;
+
 	UPROPERTY()
 	UGridlyDataTable* GridlyDataTable;
 };
@@ -7,11 +7,13 @@
 #include "DesktopPlatformModule.h"
 #include "GridlyEditor.h"
 #include "GridlyExporter.h"
+#include "GridlyExportPipeline.h"
 #include "GridlyGameSettings.h"
+#include "GridlyHttpClient.h"
+#include "GridlyHttpCompression.h"
 #include "GridlyStyle.h"
 #include "GridlyTableRow.h"
 #include "GridlyTask_ImportDataTableFromGridly.h"
-#include "HttpModule.h"
 #include "IDesktopPlatform.h"
 #include "JsonObjectConverter.h"
 #include "Slate.h"
@@ -281,6 +283,7 @@ void FAssetTypeActions_GridlyDataTable::ImportFromGridly(UGridlyDataTable* DataT
 
 	UGridlyTask_ImportDataTableFromGridly* Task =
 		UGridlyTask_ImportDataTableFromGridly::ImportDataTableFromGridly(nullptr, GridlyDataTable);
+	Task->RequestPriority = EGridlyRequestPriority::Interactive;
 
 	FDataTableEditorUtils::BroadcastPreChange(GridlyDataTable, FDataTableEditorUtils::EDataTableChangeInfo::RowList);
 
@@ -313,35 +316,22 @@ void FAssetTypeActions_GridlyDataTable::ImportFromGridly(UGridlyDataTable* DataT
 	Task->Activate();
 }
 
-bool CreateExportRequest(const UGridlyDataTable* GridlyDataTable,
-	const size_t StartIndex, TSharedPtr<IHttpRequest, ESPMode::ThreadSafe>& ExportRequest)
+FHttpRequestPtr CreateExportRequest(const UGridlyDataTable* GridlyDataTable, const size_t StartIndex)
 {
 	FString JsonString;
 	if (FGridlyExporter::ConvertToJson(GridlyDataTable, JsonString, StartIndex,
 		GetMutableDefault<UGridlyGameSettings>()->ExportMaxRecordsPerRequest))
 	{
 		const UGridlyGameSettings* GameSettings = GetMutableDefault<UGridlyGameSettings>();
-		const FString ApiKey = GameSettings->ExportApiKey;
-		const FString ViewId = GridlyDataTable->ViewId;
+		const FString Url = FGridlyHttpClient::GetViewRecordsUrl(GridlyDataTable->ViewId);
 
-		FStringFormatNamedArguments Args;
-		Args.Add(TEXT("ViewId"), *ViewId);
-		const FString Url = FString::Format(TEXT("https://api.gridly.com/v1/views/{ViewId}/records"), Args);
+		const FHttpRequestPtr HttpRequest = FGridlyHttpClient::CreateRequest(TEXT("POST"), Url, GameSettings->ExportApiKey);
+		FGridlyHttpCompression::SetContent(*HttpRequest, JsonString);
 
-		const auto HttpRequest = FHttpModule::Get().CreateRequest();
-		HttpRequest->SetHeader(TEXT("Accept"), TEXT("application/json"));
-		HttpRequest->SetHeader(TEXT("Content-Type"), TEXT("application/json"));
-		HttpRequest->SetHeader(TEXT("Authorization"), FString::Printf(TEXT("ApiKey %s"), *ApiKey));
-		HttpRequest->SetContentAsString(JsonString);
-		HttpRequest->SetVerb(TEXT("POST"));
-		HttpRequest->SetURL(Url);
-
-		ExportRequest = HttpRequest;
-
-		return true;
+		return HttpRequest;
 	}
 
-	return false;
+	return nullptr;
 }
 
 void FAssetTypeActions_GridlyDataTable::ExportToGridly(UGridlyDataTable* DataTable)
@@ -359,60 +349,46 @@ void FAssetTypeActions_GridlyDataTable::ExportToGridly(UGridlyDataTable* DataTab
 	UGridlyDataTable* GridlyDataTable = Cast<UGridlyDataTable>(DataTable);
 	check(GridlyDataTable);
 
+	const int ChunkSize = FMath::Max(1, GetMutableDefault<UGridlyGameSettings>()->ExportMaxRecordsPerRequest);
+	const int TotalRequests = FMath::DivideAndRoundUp(GridlyDataTable->GetRowMap().Num(), ChunkSize);
+	if (TotalRequests == 0)
+	{
+		return;
+	}
+
 	TSharedPtr<FScopedSlowTask, ESPMode::Fast> ExportDataTableToGridlySlowTask = MakeShareable(new FScopedSlowTask(
-		1.f,
+		static_cast<float>(TotalRequests),
 		LOCTEXT("ExportGridlyDataTableSlowTask", "Exporting data table to Gridly")));
+	ExportDataTableToGridlySlowTask->MakeDialog();
 
-	size_t TotalRequests = 0;
-	size_t StartIndex = 0;
-	TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> HttpRequest;
-	while (CreateExportRequest(GridlyDataTable, StartIndex, HttpRequest))
-	{
-		HttpRequest->OnProcessRequestComplete().
-		             BindLambda([this, ExportDataTableToGridlySlowTask](FHttpRequestPtr HttpRequest,
-			             FHttpResponsePtr HttpResponse, bool bSuccess) mutable
-			             {
-				             if (bSuccess
-				                 && (HttpResponse->GetResponseCode() == EHttpResponseCodes::Ok ||
-				                     HttpResponse->GetResponseCode() == EHttpResponseCodes::Created))
-				             {
-					             ExportDataTableToGridlySlowTask->EnterProgressFrame(1.f);
-
-					             TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> NextHttpRequest;
-					             if (this->ExportRequestQueue.Dequeue(NextHttpRequest))
-					             {
-						             NextHttpRequest->ProcessRequest();
-					             }
-					             else
-					             {
-						             ExportDataTableToGridlySlowTask.Reset();
-					             }
-				             }
-				             else
-				             {
-					             ExportDataTableToGridlySlowTask.Reset();
-					             const FString Content = HttpResponse->GetContentAsString();
-					             const FString ErrorReason =
-						             FString::Printf(TEXT("Error: %d, reason: %s"), HttpResponse->GetResponseCode(), *Content);
-					             UE_LOG(LogGridlyEditor, Error, TEXT("%s"), *ErrorReason);
-					             FMessageDialog::Open(EAppMsgType::Ok, FText::FromString(ErrorReason));
-				             }
-			             });
-		ExportRequestQueue.Enqueue(HttpRequest);
-		StartIndex += GetMutableDefault<UGridlyGameSettings>()->ExportMaxRecordsPerRequest;
-		TotalRequests++;
-	}
+	// Request bodies are built from the table when a chunk gets a slot, so it must stay alive until the export is done
 
-	if (ExportRequestQueue.Dequeue(HttpRequest))
-	{
-		ExportDataTableToGridlySlowTask->TotalAmountOfWork = static_cast<float>(TotalRequests);
-		ExportDataTableToGridlySlowTask->MakeDialog();
-		HttpRequest->ProcessRequest();
-	}
-	else
+	TWeakObjectPtr<UGridlyDataTable> WeakGridlyDataTable = GridlyDataTable;
+	ExportPipeline = MakeShared<FGridlyExportPipeline>(TotalRequests,
+		FGridlyCreateExportRequestDelegate::CreateLambda([WeakGridlyDataTable, ChunkSize](int ChunkIndex) -> FHttpRequestPtr
+		{
+			const UGridlyDataTable* ExportedDataTable = WeakGridlyDataTable.Get();
+			return ExportedDataTable ? CreateExportRequest(ExportedDataTable, static_cast<size_t>(ChunkIndex) * ChunkSize) : nullptr;
+		}));
+
+	ExportPipeline->OnChunkComplete.BindLambda([ExportDataTableToGridlySlowTask](int ChunkIndex, FHttpResponsePtr HttpResponse)
 	{
-		ExportDataTableToGridlySlowTask.Reset();
-	}
+		ExportDataTableToGridlySlowTask->EnterProgressFrame(1.f);
+	});
+
+	ExportPipeline->OnFinished.BindLambda([this, ExportDataTableToGridlySlowTask](bool bSuccess,
+		const FString& ErrorMessage) mutable
+		{
+			ExportDataTableToGridlySlowTask.Reset();
+			ExportPipeline.Reset();
+
+			if (!bSuccess)
+			{
+				FMessageDialog::Open(EAppMsgType::Ok, FText::FromString(ErrorMessage));
+			}
+		});
+
+	ExportPipeline->Start();
 }
 
 void FAssetTypeActions_GridlyDataTable::AddToolbarButton(FToolBarBuilder& Builder)
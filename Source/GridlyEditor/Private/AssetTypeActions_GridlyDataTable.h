@@ -28,6 +28,6 @@ private:
 	void ExportToGridly(UGridlyDataTable* DataTable);
 	void AddToolbarButton(FToolBarBuilder& Builder);
 
-	TQueue<TSharedPtr<IHttpRequest, ESPMode::ThreadSafe>> ExportRequestQueue;
+	TSharedPtr<class FGridlyExportPipeline> ExportPipeline;
 	static TMap<uint32, TSharedPtr<FScopedSlowTask, ESPMode::ThreadSafe>> ImportSlowTasks;
 };
@@ -0,0 +1,146 @@
+// Copyright (c) 2021 LocalizeDirect AB
+
+#include "GridlyExportLedger.h"
+
+#include "GridlyEditor.h"
+#include "GridlyExporter.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace GridlyExportLedger
+{
+constexpr uint32 FileMagic = 0x4C584447;	// "GDXL"
+
+// Bump when the layout or the way cells are hashed changes, older ledgers are then discarded
+constexpr int32 FileVersion = 1;
+}
+
+const TCHAR* FGridlyExportLedger::PathKey = TEXT("$path");
+
+void FGridlyExportLedger::Load(const FString& InViewId)
+{
+	ViewId = InViewId;
+	Records.Reset();
+
+	TArray<uint8> FileData;
+	if (!FFileHelper::LoadFileToArray(FileData, *GetFilePath(ViewId), FILEREAD_Silent))
+	{
+		return;
+	}
+
+	FMemoryReader Reader(FileData);
+
+	uint32 Magic = 0;
+	int32 Version = 0;
+	Reader << Magic;
+	Reader << Version;
+
+	if (Magic != GridlyExportLedger::FileMagic || Version != GridlyExportLedger::FileVersion)
+	{
+		UE_LOG(LogGridlyEditor, Log, TEXT("Export ledger of view ID %s is out of date, exporting all records"), *ViewId);
+		return;
+	}
+
+	Reader << Records;
+
+	if (Reader.IsError())
+	{
+		UE_LOG(LogGridlyEditor, Warning, TEXT("Failed to read export ledger of view ID %s, exporting all records"), *ViewId);
+		Records.Reset();
+	}
+}
+
+bool FGridlyExportLedger::Save()
+{
+	TArray<uint8> FileData;
+	FMemoryWriter Writer(FileData);
+
+	uint32 Magic = GridlyExportLedger::FileMagic;
+	int32 Version = GridlyExportLedger::FileVersion;
+	Writer << Magic;
+	Writer << Version;
+	Writer << Records;
+
+	const FString FilePath = GetFilePath(ViewId);
+	if (!FFileHelper::SaveArrayToFile(FileData, *FilePath))
+	{
+		UE_LOG(LogGridlyEditor, Warning, TEXT("Failed to save export ledger to %s"), *FilePath);
+		return false;
+	}
+
+	return true;
+}
+
+bool FGridlyExportLedger::HasChanged(const FString& RecordId, const FCellHashes& CellHashes) const
+{
+	const TMap<FString, uint32>* ExportedCells = Records.Find(RecordId);
+	if (!ExportedCells)
+	{
+		return true;
+	}
+
+	for (const TPair<FString, uint32>& CellHash : CellHashes)
+	{
+		const uint32* ExportedHash = ExportedCells->Find(CellHash.Key);
+		if (!ExportedHash || *ExportedHash != CellHash.Value)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool FGridlyExportLedger::GetChangedCells(const FString& RecordId, const FCellHashes& CellHashes,
+	FCellHashes& OutChangedCellHashes) const
+{
+	OutChangedCellHashes.Reset();
+
+	const TMap<FString, uint32>* ExportedCells = Records.Find(RecordId);
+	for (const TPair<FString, uint32>& CellHash : CellHashes)
+	{
+		const uint32* ExportedHash = ExportedCells ? ExportedCells->Find(CellHash.Key) : nullptr;
+		if (!ExportedHash || *ExportedHash != CellHash.Value)
+		{
+			OutChangedCellHashes.Add(CellHash);
+		}
+	}
+
+	return OutChangedCellHashes.Num() > 0;
+}
+
+void FGridlyExportLedger::Commit(const FString& RecordId, const FCellHashes& CellHashes)
+{
+	TMap<FString, uint32>& ExportedCells = Records.FindOrAdd(RecordId);
+	for (const TPair<FString, uint32>& CellHash : CellHashes)
+	{
+		ExportedCells.Add(CellHash.Key, CellHash.Value);
+	}
+}
+
+int FGridlyExportLedger::Num() const
+{
+	return Records.Num();
+}
+
+void FGridlyExportLedger::HashRecord(const FGridlyExportRecord& Record, FCellHashes& OutCellHashes)
+{
+	OutCellHashes.Reset(Record.Cells.Num() + 1);
+
+	if (Record.bHasPath)
+	{
+		OutCellHashes.Emplace(PathKey, FCrc::StrCrc32(*Record.Path));
+	}
+
+	for (const FGridlyExportCell& Cell : Record.Cells)
+	{
+		OutCellHashes.Emplace(Cell.ColumnId, FGridlyExporter::HashCell(Cell));
+	}
+}
+
+FString FGridlyExportLedger::GetFilePath(const FString& ViewId)
+{
+	return FPaths::ProjectSavedDir() / TEXT("Gridly") / TEXT("ExportLedger") / (ViewId + TEXT(".bin"));
+}
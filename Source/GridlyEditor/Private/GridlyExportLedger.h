@@ -0,0 +1,42 @@
+// Copyright (c) 2021 LocalizeDirect AB
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FGridlyExportRecord;
+
+/**
+ * Content hashes of every cell as of the last successful export to a view, persisted under Saved/Gridly/ExportLedger.
+ * Exports compare against it to skip records that have not changed since they were last pushed. Deleting the file forces
+ * the next export to send everything again.
+ */
+class FGridlyExportLedger
+{
+public:
+	/** Column ID and content hash of each cell of a record, the path is stored under PathKey */
+	typedef TArray<TPair<FString, uint32>> FCellHashes;
+
+	static const TCHAR* PathKey;
+
+	void Load(const FString& InViewId);
+	bool Save();
+
+	/** True if any cell is new or differs from the last export. Cells the ledger has but the record lacks are ignored */
+	bool HasChanged(const FString& RecordId, const FCellHashes& CellHashes) const;
+
+	/** Collects the cells that are new or differ from the last export, returns false if there are none */
+	bool GetChangedCells(const FString& RecordId, const FCellHashes& CellHashes, FCellHashes& OutChangedCellHashes) const;
+
+	/** Records the cells as exported, once the request that sent them has succeeded */
+	void Commit(const FString& RecordId, const FCellHashes& CellHashes);
+
+	int Num() const;
+
+	static void HashRecord(const FGridlyExportRecord& Record, FCellHashes& OutCellHashes);
+	static FString GetFilePath(const FString& ViewId);
+
+private:
+	FString ViewId;
+	TMap<FString, TMap<FString, uint32>> Records;
+};
@@ -0,0 +1,143 @@
+// Copyright (c) 2021 LocalizeDirect AB
+
+#include "GridlyExportPipeline.h"
+
+#include "GridlyEditor.h"
+#include "GridlyGameSettings.h"
+#include "GridlyHttpCompression.h"
+#include "Interfaces/IHttpResponse.h"
+
+FGridlyExportPipeline::FGridlyExportPipeline(int InNumChunks, const FGridlyCreateExportRequestDelegate& InCreateRequestDelegate) :
+	CreateRequestDelegate(InCreateRequestDelegate),
+	NumChunks(InNumChunks),
+	NextChunkIndex(0),
+	NumCompletedChunks(0),
+	MaxConcurrentRequests(1),
+	bRunning(false)
+{
+}
+
+void FGridlyExportPipeline::Start()
+{
+	// The owner calls in through a plain pointer and may release the pipeline when it finishes before any request is sent
+
+	const TSharedRef<FGridlyExportPipeline> KeepAlive = AsShared();
+
+	MaxConcurrentRequests = FMath::Max(1, GetMutableDefault<UGridlyGameSettings>()->ExportMaxConcurrentRequests);
+	NextChunkIndex = 0;
+	NumCompletedChunks = 0;
+	bRunning = true;
+
+	if (NumChunks > 0)
+	{
+		FillWindow();
+	}
+	else
+	{
+		Finish(true, FString());
+	}
+}
+
+void FGridlyExportPipeline::Cancel()
+{
+	bRunning = false;
+
+	TArray<FGridlyRequestId> RequestIds;
+	PendingRequests.GenerateValueArray(RequestIds);
+	PendingRequests.Reset();
+
+	for (const FGridlyRequestId RequestId : RequestIds)
+	{
+		FGridlyHttpClient::Get().Cancel(RequestId);
+	}
+}
+
+bool FGridlyExportPipeline::IsRunning() const
+{
+	return bRunning;
+}
+
+int FGridlyExportPipeline::GetNumChunks() const
+{
+	return NumChunks;
+}
+
+void FGridlyExportPipeline::FillWindow()
+{
+	while (bRunning && PendingRequests.Num() < MaxConcurrentRequests && NextChunkIndex < NumChunks)
+	{
+		// The pipeline is finished on failure, and must not be touched anymore
+		if (!SendChunk(NextChunkIndex++))
+		{
+			return;
+		}
+	}
+}
+
+bool FGridlyExportPipeline::SendChunk(int ChunkIndex)
+{
+	// The request body is only built once the chunk has a slot
+
+	const FHttpRequestPtr HttpRequest = CreateRequestDelegate.Execute(ChunkIndex);
+	if (!HttpRequest.IsValid())
+	{
+		Finish(false, FString::Printf(TEXT("Failed to create export request for chunk %d"), ChunkIndex));
+		return false;
+	}
+
+	PendingRequests.Add(ChunkIndex, FGridlyHttpClient::Get().Send(HttpRequest, Priority,
+		FGridlyRequestCompleteDelegate::CreateSP(this, &FGridlyExportPipeline::OnRequestComplete, ChunkIndex)));
+	return true;
+}
+
+void FGridlyExportPipeline::OnRequestComplete(FHttpRequestPtr HttpRequestPtr, FHttpResponsePtr HttpResponsePtr, bool bSuccess,
+	const FGridlyRequestTiming& Timing, int ChunkIndex)
+{
+	if (!bRunning)
+	{
+		return;
+	}
+
+	PendingRequests.Remove(ChunkIndex);
+
+	if (bSuccess
+	    && (HttpResponsePtr->GetResponseCode() == EHttpResponseCodes::Ok
+	        || HttpResponsePtr->GetResponseCode() == EHttpResponseCodes::Created))
+	{
+		NumCompletedChunks++;
+		OnChunkComplete.ExecuteIfBound(ChunkIndex, HttpResponsePtr);
+
+		if (NumCompletedChunks == NumChunks)
+		{
+			Finish(true, FString());
+		}
+		else
+		{
+			FillWindow();
+		}
+	}
+	else if (bSuccess)
+	{
+		Finish(false, FString::Printf(TEXT("Error: %d, reason: %s"), HttpResponsePtr->GetResponseCode(),
+			*FGridlyHttpCompression::GetContentAsString(HttpResponsePtr)));
+	}
+	else
+	{
+		Finish(false, TEXT("ERROR: Unable to connect to Gridly"));
+	}
+}
+
+void FGridlyExportPipeline::Finish(bool bSuccess, const FString& ErrorMessage)
+{
+	if (!bSuccess)
+	{
+		UE_LOG(LogGridlyEditor, Error, TEXT("%s"), *ErrorMessage);
+	}
+
+	// Keep the pipeline alive while the owner reacts, it may release its reference from the callback
+
+	const TSharedRef<FGridlyExportPipeline> KeepAlive = AsShared();
+
+	Cancel();
+	OnFinished.ExecuteIfBound(bSuccess, ErrorMessage);
+}
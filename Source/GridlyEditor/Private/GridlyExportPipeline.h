@@ -0,0 +1,56 @@
+// Copyright (c) 2021 LocalizeDirect AB
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "GridlyHttpClient.h"
+#include "Interfaces/IHttpRequest.h"
+
+DECLARE_DELEGATE_RetVal_OneParam(FHttpRequestPtr, FGridlyCreateExportRequestDelegate, int /* ChunkIndex */);
+DECLARE_DELEGATE_TwoParams(FGridlyExportChunkCompleteDelegate, int /* ChunkIndex */, FHttpResponsePtr);
+DECLARE_DELEGATE_TwoParams(FGridlyExportFinishedDelegate, bool /* bSuccess */, const FString& /* ErrorMessage */);
+
+/**
+ * Uploads a fixed number of chunks with up to ExportMaxConcurrentRequests requests queued in the HTTP client. A request is only
+ * created once a slot opens, and failed chunks are retried by the client without holding up the other slots.
+ */
+class FGridlyExportPipeline : public TSharedFromThis<FGridlyExportPipeline>
+{
+public:
+	FGridlyExportPipeline(int InNumChunks, const FGridlyCreateExportRequestDelegate& InCreateRequestDelegate);
+
+	void Start();
+	void Cancel();
+
+	bool IsRunning() const;
+	int GetNumChunks() const;
+
+public:
+	/** Called once per chunk when it has been uploaded successfully, in completion order */
+	FGridlyExportChunkCompleteDelegate OnChunkComplete;
+
+	/** Called once, after every chunk has completed or on the first chunk that fails for good */
+	FGridlyExportFinishedDelegate OnFinished;
+
+	EGridlyRequestPriority Priority = EGridlyRequestPriority::Interactive;
+
+private:
+	void FillWindow();
+	/** Returns false if the chunk could not be created, in which case the pipeline has finished */
+	bool SendChunk(int ChunkIndex);
+	void OnRequestComplete(FHttpRequestPtr HttpRequestPtr, FHttpResponsePtr HttpResponsePtr, bool bSuccess,
+		const FGridlyRequestTiming& Timing, int ChunkIndex);
+	void Finish(bool bSuccess, const FString& ErrorMessage);
+
+	FGridlyCreateExportRequestDelegate CreateRequestDelegate;
+
+	int NumChunks;
+	int NextChunkIndex;
+	int NumCompletedChunks;
+	int MaxConcurrentRequests;
+	bool bRunning;
+
+	// Chunks that have a request in flight or queued in the HTTP client
+	TMap<int, FGridlyRequestId> PendingRequests;
+};
@@ -1,187 +1,283 @@
 #include "GridlyExporter.h"
 
-#include "Dom/JsonObject.h"
-#include "Dom/JsonValue.h"
 #include "GridlyCultureConverter.h"
 #include "GridlyDataTableImporterJSON.h"
 #include "GridlyGameSettings.h"
 #include "Internationalization/PolyglotTextData.h"
 #include "LocTextHelper.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+#include "Serialization/JsonWriter.h"
 
-bool FGridlyExporter::ConvertToJson(const TArray<FPolyglotTextData>& PolyglotTextDatas, bool bIncludeTargetTranslations,
-	const TSharedPtr<FLocTextHelper>& LocTextHelperPtr, FString& OutJsonString)
+FGridlyPolyglotRecordBuilder::FGridlyPolyglotRecordBuilder(bool bIncludeTargetTranslations,
+	const TSharedPtr<FLocTextHelper>& InLocTextHelperPtr) :
+	LocTextHelperPtr(InLocTextHelperPtr)
 {
-	UGridlyGameSettings* GameSettings = GetMutableDefault<UGridlyGameSettings>();
-	const TArray<FString> TargetCultures = FGridlyCultureConverter::GetTargetCultures();
-
-	const bool bUseCombinedNamespaceKey = GameSettings->bUseCombinedNamespaceId;
-	const bool bUsedMakeUniqueRecordId = GameSettings->bMakeUniqueRecordId;
-	const bool bExportNamespace = !bUseCombinedNamespaceKey || GameSettings->bAlsoExportNamespaceColumn;
-	const bool bUsePathAsNamespace = GameSettings->NamespaceColumnId == "path";
+	const UGridlyGameSettings* GameSettings = GetMutableDefault<UGridlyGameSettings>();
+
+	bUseCombinedNamespaceKey = GameSettings->bUseCombinedNamespaceId;
+	bUsedMakeUniqueRecordId = GameSettings->bMakeUniqueRecordId;
+	bExportNamespace = !bUseCombinedNamespaceKey || GameSettings->bAlsoExportNamespaceColumn;
+	bUsePathAsNamespace = GameSettings->NamespaceColumnId == "path";
+	bExportContext = GameSettings->bExportContext;
+	bExportMetadata = GameSettings->bExportMetadata;
+	NamespaceColumnId = GameSettings->NamespaceColumnId;
+	ContextColumnId = GameSettings->ContextColumnId;
+	SourceLanguageColumnIdPrefix = GameSettings->SourceLanguageColumnIdPrefix;
+	MetadataMapping = GameSettings->MetadataMapping;
+
+	// Column ids only depend on the culture, so they are resolved once rather than per record
+
+	if (bIncludeTargetTranslations)
+	{
+		const TArray<FString> TargetCultures = FGridlyCultureConverter::GetTargetCultures();
+		for (const FString& CultureName : TargetCultures)
+		{
+			FString GridlyCulture;
+			if (FGridlyCultureConverter::ConvertToGridly(CultureName, GridlyCulture))
+			{
+				TargetColumnIds.Emplace(CultureName, GameSettings->TargetLanguageColumnIdPrefix + GridlyCulture);
+			}
+		}
+	}
+}
 
-	TArray<TSharedPtr<FJsonValue>> Rows;
+FString FGridlyPolyglotRecordBuilder::GetRecordId(const FPolyglotTextData& PolyglotTextData) const
+{
+	const FString& Key = PolyglotTextData.GetKey();
+	const FString& Namespace = PolyglotTextData.GetNamespace();
 
-	for (int i = 0; i < PolyglotTextDatas.Num(); i++)
+	if (bUseCombinedNamespaceKey)
 	{
-		TSharedPtr<FJsonObject> RowJsonObject = MakeShareable(new FJsonObject);
-		TArray<TSharedPtr<FJsonValue>> CellsJsonArray;
+		// Combine Namespace and Key
+		FString CombinedKey = FString::Printf(TEXT("%s,%s"), *Namespace, *Key);
 
-		const FString& Key = PolyglotTextDatas[i].GetKey();
-		const FString& Namespace = PolyglotTextDatas[i].GetNamespace();
-
-		const FManifestContext* ItemContext = nullptr;
-		if (LocTextHelperPtr.IsValid())
+		if (bUsedMakeUniqueRecordId)
 		{
-			TSharedPtr<FManifestEntry> ManifestEntry = LocTextHelperPtr->FindSourceText(Namespace, Key);
-			ItemContext = ManifestEntry ? ManifestEntry->FindContextByKey(Key) : nullptr;
+			// Generate a hash of the CombinedKey
+			uint32 KeyHash = GetTypeHash(CombinedKey);
+			FString HashString = FString::Printf(TEXT("%u"), KeyHash);
+			return HashString + TEXT("_") + CombinedKey;
 		}
 
-		if (bUseCombinedNamespaceKey)
-		{
-			// Combine Namespace and Key
-			FString CombinedKey = FString::Printf(TEXT("%s,%s"), *Namespace, *Key);
+		return CombinedKey;
+	}
 
-			if (bUsedMakeUniqueRecordId)
-			{
-				// Generate a hash of the CombinedKey
-				uint32 KeyHash = GetTypeHash(CombinedKey);
-				FString HashString = FString::Printf(TEXT("%u"), KeyHash);
-				FString KeyWithHash = HashString + TEXT("_") + CombinedKey;
-				RowJsonObject->SetStringField("id", KeyWithHash);
-			}
-			else
-			{
-				RowJsonObject->SetStringField("id", CombinedKey);
-			}
+	if (bUsedMakeUniqueRecordId)
+	{
+		// Generate a hash of the Key
+		uint32 KeyHash = GetTypeHash(Key);
+		FString HashString = FString::Printf(TEXT("%u"), KeyHash);
+		return HashString + TEXT("_") + Key;
+	}
+
+	return Key;
+}
+
+void FGridlyPolyglotRecordBuilder::Build(const FPolyglotTextData& PolyglotTextData, FGridlyExportRecord& OutRecord)
+{
+	const FString& Key = PolyglotTextData.GetKey();
+	const FString& Namespace = PolyglotTextData.GetNamespace();
+
+	OutRecord.Id = GetRecordId(PolyglotTextData);
+	OutRecord.Path.Reset();
+	OutRecord.bHasPath = false;
+	OutRecord.Cells.Reset();
+
+	const FManifestContext* ItemContext = nullptr;
+	if (LocTextHelperPtr.IsValid())
+	{
+		TSharedPtr<FManifestEntry> ManifestEntry = LocTextHelperPtr->FindSourceText(Namespace, Key);
+		ItemContext = ManifestEntry ? ManifestEntry->FindContextByKey(Key) : nullptr;
+	}
+
+	// Set namespace/path
+
+	if (bExportNamespace)
+	{
+		if (bUsePathAsNamespace)
+		{
+			OutRecord.Path = Namespace;
+			OutRecord.bHasPath = true;
 		}
-		else
+		else if (!NamespaceColumnId.IsEmpty())
 		{
-			if (bUsedMakeUniqueRecordId)
-			{
-				// Generate a hash of the Key
-				uint32 KeyHash = GetTypeHash(Key);
-				FString HashString = FString::Printf(TEXT("%u"), KeyHash);
-				FString KeyWithHash = HashString + TEXT("_") + Key;
-				RowJsonObject->SetStringField("id", KeyWithHash);
-			}
-			else
-			{
-				RowJsonObject->SetStringField("id", Key);
-			}
+			OutRecord.Cells.Emplace(NamespaceColumnId, Namespace);
 		}
+	}
+
+	// Set source language text
+
+	const FString& NativeCulture = PolyglotTextData.GetNativeCulture();
+
+	const FString* SourceColumnId = SourceColumnIds.Find(NativeCulture);
+	if (!SourceColumnId)
+	{
+		FString GridlyCulture;
+		SourceColumnId = &SourceColumnIds.Add(NativeCulture,
+			FGridlyCultureConverter::ConvertToGridly(NativeCulture, GridlyCulture)
+				? SourceLanguageColumnIdPrefix + GridlyCulture
+				: FString());
+	}
+
+	if (!SourceColumnId->IsEmpty())
+	{
+		OutRecord.Cells.Emplace(*SourceColumnId, PolyglotTextData.GetNativeString());
+	}
 
-		// Set namespace/path
+	// Add context
 
-		if (bExportNamespace)
+	if (ItemContext && bExportContext)
+	{
+		OutRecord.Cells.Emplace(ContextColumnId,
+			ItemContext->SourceLocation.Replace(TEXT(" - line "), TEXT(":"), ESearchCase::CaseSensitive));
+	}
+
+	// Add metadata
+
+	if (ItemContext && bExportMetadata && ItemContext->InfoMetadataObj.IsValid())
+	{
+		for (const auto& InfoMetaDataPair : ItemContext->InfoMetadataObj->Values)
 		{
-			if (bUsePathAsNamespace)
-			{
-				RowJsonObject->SetStringField("path", Namespace);
-			}
-			else if (!GameSettings->NamespaceColumnId.IsEmpty())
+			if (const FGridlyColumnInfo* GridlyColumnInfo = MetadataMapping.Find(InfoMetaDataPair.Key))
 			{
-				TSharedPtr<FJsonObject> CellJsonObject = MakeShareable(new FJsonObject);
-				CellJsonObject->SetStringField("columnId", GameSettings->NamespaceColumnId);
-				CellJsonObject->SetStringField("value", Namespace);
-				CellsJsonArray.Add(MakeShareable(new FJsonValueObject(CellJsonObject)));
+				const TSharedPtr<FLocMetadataValue> Value = InfoMetaDataPair.Value;
+
+				switch (GridlyColumnInfo->DataType)
+				{
+					case EGridlyColumnDataType::String:
+					{
+						OutRecord.Cells.Emplace(GridlyColumnInfo->Name, Value->ToString());
+					}
+					break;
+					case EGridlyColumnDataType::Number:
+					{
+						OutRecord.Cells.Emplace(GridlyColumnInfo->Name,
+							FString::FromInt(FCString::Atoi(*Value->ToString())), true);
+					}
+					break;
+					default:
+					{
+						// The cell is still sent, without a value
+						OutRecord.Cells.Emplace(GridlyColumnInfo->Name, FString(), false, false);
+					}
+					break;
+				}
 			}
 		}
+	}
 
-		// Set source language text
+	// Add translations
+
+	for (const TPair<FString, FString>& TargetColumnId : TargetColumnIds)
+	{
+		FString LocalizedString;
 
+		if (TargetColumnId.Key != NativeCulture
+		    && PolyglotTextData.GetLocalizedString(TargetColumnId.Key, LocalizedString)
+		    && !LocalizedString.IsEmpty())
 		{
-			const FString NativeCulture = PolyglotTextDatas[i].GetNativeCulture();
-			const FString NativeString = PolyglotTextDatas[i].GetNativeString();
+			OutRecord.Cells.Emplace(TargetColumnId.Value, MoveTemp(LocalizedString));
+		}
+	}
+}
 
-			FString GridlyCulture;
-			if (FGridlyCultureConverter::ConvertToGridly(NativeCulture, GridlyCulture))
-			{
-				TSharedPtr<FJsonObject> CellJsonObject = MakeShareable(new FJsonObject);
-				CellJsonObject->SetStringField("columnId", GameSettings->SourceLanguageColumnIdPrefix + GridlyCulture);
-				CellJsonObject->SetStringField("value", NativeString);
-				CellsJsonArray.Add(MakeShareable(new FJsonValueObject(CellJsonObject)));
-			}
+uint32 FGridlyExporter::HashCell(const FGridlyExportCell& Cell)
+{
+	uint32 Hash = FCrc::StrCrc32(*Cell.Value);
+	Hash = HashCombine(Hash, GetTypeHash(Cell.bIsNumber));
+	return HashCombine(Hash, GetTypeHash(Cell.bHasValue));
+}
 
-			// Add context
+int32 FGridlyExporter::EstimateJsonSize(const FGridlyExportRecord& Record)
+{
+	// {"id":"","cells":[]} and ,"path":"" around the values, {"columnId":"","value":""}, per cell
 
-			if (ItemContext && GameSettings->bExportContext)
-			{
-				TSharedPtr<FJsonObject> CellJsonObject = MakeShareable(new FJsonObject);
-				CellJsonObject->SetStringField("columnId", *GameSettings->ContextColumnId);
-				CellJsonObject->SetStringField(
-					"value", ItemContext->SourceLocation.Replace(TEXT(" - line "), TEXT(":"), ESearchCase::CaseSensitive));
-				CellsJsonArray.Add(MakeShareable(new FJsonValueObject(CellJsonObject)));
-			}
+	int32 Size = 20 + FTCHARToUTF8_Convert::ConvertedLength(*Record.Id, Record.Id.Len());
 
-			// Add metadata
+	if (Record.bHasPath)
+	{
+		Size += 10 + FTCHARToUTF8_Convert::ConvertedLength(*Record.Path, Record.Path.Len());
+	}
 
-			if (ItemContext && GameSettings->bExportMetadata && ItemContext->InfoMetadataObj.IsValid())
-			{
-				for (const auto& InfoMetaDataPair : ItemContext->InfoMetadataObj->Values)
-				{
-					const FString& KeyName = InfoMetaDataPair.Key;
-					if (const FGridlyColumnInfo* GridlyColumnInfo = GameSettings->MetadataMapping.Find(InfoMetaDataPair.Key))
-					{
-						TSharedPtr<FJsonObject> CellJsonObject = MakeShareable(new FJsonObject);
-						CellJsonObject->SetStringField("columnId", *GridlyColumnInfo->Name);
+	for (const FGridlyExportCell& Cell : Record.Cells)
+	{
+		Size += 26 + FTCHARToUTF8_Convert::ConvertedLength(*Cell.ColumnId, Cell.ColumnId.Len())
+		        + FTCHARToUTF8_Convert::ConvertedLength(*Cell.Value, Cell.Value.Len());
+	}
 
-						const TSharedPtr<FLocMetadataValue> Value = InfoMetaDataPair.Value;
+	return Size;
+}
 
-						switch (GridlyColumnInfo->DataType)
-						{
-							case EGridlyColumnDataType::String:
-							{
-								CellJsonObject->SetStringField("value", Value->ToString());
-							}
-							break;
-							case EGridlyColumnDataType::Number:
-							{
-								CellJsonObject->SetNumberField("value", FCString::Atoi(*Value->ToString()));
-							}
-							break;
-							default:
-								break;
-						}
+void FGridlyExporter::WriteRecord(TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>& JsonWriter,
+	const FGridlyExportRecord& Record)
+{
+	JsonWriter.WriteObjectStart();
+	JsonWriter.WriteValue(TEXT("id"), Record.Id);
 
-						CellsJsonArray.Add(MakeShareable(new FJsonValueObject(CellJsonObject)));
-					}
-				}
-			}
+	if (Record.bHasPath)
+	{
+		JsonWriter.WriteValue(TEXT("path"), Record.Path);
+	}
 
-			if (bIncludeTargetTranslations)
-			{
-				for (int j = 0; j < TargetCultures.Num(); j++)
-				{
-					const FString CultureName = TargetCultures[j];
-					FString LocalizedString;
+	JsonWriter.WriteArrayStart(TEXT("cells"));
 
-					if (CultureName != NativeCulture && PolyglotTextDatas[i].GetLocalizedString(CultureName, LocalizedString) 
-						&& FGridlyCultureConverter::ConvertToGridly(CultureName, GridlyCulture)
-						&& !LocalizedString.IsEmpty())
-					{
-						TSharedPtr<FJsonObject> CellJsonObject = MakeShareable(new FJsonObject);
-						CellJsonObject->SetStringField("columnId", GameSettings->TargetLanguageColumnIdPrefix + GridlyCulture);
-						CellJsonObject->SetStringField("value", LocalizedString);
-						CellsJsonArray.Add(MakeShareable(new FJsonValueObject(CellJsonObject)));
-					}
-				}
-			}
+	for (const FGridlyExportCell& Cell : Record.Cells)
+	{
+		JsonWriter.WriteObjectStart();
+		JsonWriter.WriteValue(TEXT("columnId"), Cell.ColumnId);
+
+		if (Cell.bIsNumber)
+		{
+			JsonWriter.WriteRawJSONValue(TEXT("value"), Cell.Value);
+		}
+		else if (Cell.bHasValue)
+		{
+			JsonWriter.WriteValue(TEXT("value"), Cell.Value);
 		}
 
-		// Assign array
+		JsonWriter.WriteObjectEnd();
+	}
 
-		RowJsonObject->SetArrayField("cells", CellsJsonArray);
+	JsonWriter.WriteArrayEnd();
+	JsonWriter.WriteObjectEnd();
+}
 
-		Rows.Add(MakeShareable(new FJsonValueObject(RowJsonObject)));
-	}
+bool FGridlyExporter::ConvertToJson(TArrayView<const FPolyglotTextData> PolyglotTextDatas, bool bIncludeTargetTranslations,
+	const TSharedPtr<FLocTextHelper>& LocTextHelperPtr, FString& OutJsonString)
+{
+	FGridlyPolyglotRecordBuilder RecordBuilder(bIncludeTargetTranslations, LocTextHelperPtr);
+	return ConvertToJson(PolyglotTextDatas, RecordBuilder, OutJsonString);
+}
 
-	const TSharedRef<TJsonWriter<>> JsonWriter = TJsonStringWriter<>::Create(&OutJsonString);
-	if (FJsonSerializer::Serialize(Rows, JsonWriter))
+bool FGridlyExporter::ConvertToJson(TArrayView<const FPolyglotTextData> PolyglotTextDatas,
+	FGridlyPolyglotRecordBuilder& RecordBuilder, FString& OutJsonString)
+{
+	return ConvertToJson(PolyglotTextDatas, RecordBuilder, OutJsonString, [](int, FGridlyExportRecord&) {});
+}
+
+bool FGridlyExporter::ConvertToJson(TArrayView<const FPolyglotTextData> PolyglotTextDatas,
+	FGridlyPolyglotRecordBuilder& RecordBuilder, FString& OutJsonString,
+	TFunctionRef<void(int Index, FGridlyExportRecord& Record)> FilterRecord)
+{
+	// Records are written straight into the output string, which keeps its allocation between calls
+
+	OutJsonString.Reset();
+	const TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> JsonWriter =
+		TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&OutJsonString);
+
+	JsonWriter->WriteArrayStart();
+
+	FGridlyExportRecord Record;
+	for (int i = 0; i < PolyglotTextDatas.Num(); i++)
 	{
-		return true;
+		RecordBuilder.Build(PolyglotTextDatas[i], Record);
+		FilterRecord(i, Record);
+		WriteRecord(*JsonWriter, Record);
 	}
 
-	return false;
+	JsonWriter->WriteArrayEnd();
+
+	return JsonWriter->Close();
 }
 
 // Function to generate a random letter
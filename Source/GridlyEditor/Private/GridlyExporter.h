@@ -3,14 +3,80 @@
 #pragma once
 
 #include "GridlyDataTable.h"
+#include "GridlyGameSettings.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+#include "Serialization/JsonWriter.h"
 
 class FLocTextHelper;
 
+struct FGridlyExportCell
+{
+	FGridlyExportCell(const FString& InColumnId, const FString& InValue, bool bInIsNumber = false, bool bInHasValue = true) :
+		ColumnId(InColumnId),
+		Value(InValue),
+		bIsNumber(bInIsNumber),
+		bHasValue(bInHasValue)
+	{
+	}
+
+	FString ColumnId;
+	FString Value;
+	bool bIsNumber;
+	bool bHasValue;
+};
+
+/** A record as it is sent to Gridly */
+struct FGridlyExportRecord
+{
+	FString Id;
+	FString Path;
+	bool bHasPath = false;
+	TArray<FGridlyExportCell> Cells;
+};
+
+/** Turns texts into export records. The settings are captured on construction, so one builder can be reused for a whole export */
+class FGridlyPolyglotRecordBuilder
+{
+public:
+	FGridlyPolyglotRecordBuilder(bool bIncludeTargetTranslations, const TSharedPtr<FLocTextHelper>& InLocTextHelperPtr);
+
+	FString GetRecordId(const FPolyglotTextData& PolyglotTextData) const;
+	void Build(const FPolyglotTextData& PolyglotTextData, FGridlyExportRecord& OutRecord);
+
+private:
+	TSharedPtr<FLocTextHelper> LocTextHelperPtr;
+
+	bool bUseCombinedNamespaceKey;
+	bool bUsedMakeUniqueRecordId;
+	bool bExportNamespace;
+	bool bUsePathAsNamespace;
+	bool bExportContext;
+	bool bExportMetadata;
+	FString NamespaceColumnId;
+	FString ContextColumnId;
+	FString SourceLanguageColumnIdPrefix;
+	TMap<FString, FGridlyColumnInfo> MetadataMapping;
+
+	TArray<TPair<FString, FString>> TargetColumnIds;
+	TMap<FString, FString> SourceColumnIds;
+};
+
 class FGridlyExporter
 {
 public:
-	static bool ConvertToJson(const TArray<FPolyglotTextData>& PolyglotTextDatas, bool bIncludeTargetTranslations,
+	static bool ConvertToJson(TArrayView<const FPolyglotTextData> PolyglotTextDatas, bool bIncludeTargetTranslations,
 		const TSharedPtr<FLocTextHelper>& LocTextHelperPtr, FString& OutJsonString);
+	static bool ConvertToJson(TArrayView<const FPolyglotTextData> PolyglotTextDatas, FGridlyPolyglotRecordBuilder& RecordBuilder,
+		FString& OutJsonString);
+
+	/** Lets the caller drop cells from each record before it is written, Index is relative to PolyglotTextDatas */
+	static bool ConvertToJson(TArrayView<const FPolyglotTextData> PolyglotTextDatas, FGridlyPolyglotRecordBuilder& RecordBuilder,
+		FString& OutJsonString, TFunctionRef<void(int Index, FGridlyExportRecord& Record)> FilterRecord);
+	static void WriteRecord(TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>& JsonWriter, const FGridlyExportRecord& Record);
+	static uint32 HashCell(const FGridlyExportCell& Cell);
+
+	/** Size in bytes of the record once written as UTF-8, give or take escaped characters */
+	static int32 EstimateJsonSize(const FGridlyExportRecord& Record);
 	static bool ConvertToJson(const UGridlyDataTable* GridlyDataTable, FString& OutJsonString, size_t StartIndex, size_t MaxSize);
 	static char getRandomLetter();
 	static int getRandomNumber();
@@ -9,6 +9,7 @@
 #include "LocalizationTargetTypes.h"
 #include "HttpModule.h"
 #include "HttpManager.h"
+#include "Containers/Ticker.h"
 #include "LocalizationConfigurationScript.h"
 
 #include "UObject/UObjectGlobals.h"
@@ -94,11 +95,11 @@ int32 UGridlyImportExportCommandlet::Main(const FString& Params)
 			}
 		}
 
-		// Download cultures from Gridly
+		// Download all cultures from Gridly in a single pass over the view IDs
 		CulturesToDownload.Append(Cultures);
+		TArray<TSharedRef<FDownloadLocalizationTargetFile, ESPMode::ThreadSafe>> DownloadOperations;
 		for (const FString& CultureName : Cultures)
 		{
-			ILocalizationServiceProvider& Provider = ILocalizationServiceModule::Get().GetProvider();
 			TSharedRef<FDownloadLocalizationTargetFile, ESPMode::ThreadSafe> DownloadTargetFileOp =
 				ILocalizationServiceOperation::Create<FDownloadLocalizationTargetFile>();
 			DownloadTargetFileOp->SetInTargetGuid(FirstLocTarget->Settings.Guid);
@@ -109,18 +110,20 @@ int32 UGridlyImportExportCommandlet::Main(const FString& Params)
 			FPaths::MakePathRelativeTo(Path, *FPaths::ProjectDir());
 			DownloadTargetFileOp->SetInRelativeOutputFilePathAndName(Path);
 
-			auto OperationCompleteDelegate = FLocalizationServiceOperationComplete::CreateUObject(this,
-				&UGridlyImportExportCommandlet::OnDownloadComplete, false);
-
-			Provider.Execute(DownloadTargetFileOp, TArray<FLocalizationServiceTranslationIdentifier>(),
-				ELocalizationServiceOperationConcurrency::Synchronous, OperationCompleteDelegate);
+			DownloadOperations.Add(DownloadTargetFileOp);
 		}
 
+		auto OperationCompleteDelegate = FLocalizationServiceOperationComplete::CreateUObject(this,
+			&UGridlyImportExportCommandlet::OnDownloadComplete, false);
+
+		GridlyProvider->ExecuteMultiCultureDownload(DownloadOperations, OperationCompleteDelegate);
+
 		// Wait for all downloads
 		while (CulturesToDownload.Num())
 		{
 			FPlatformProcess::Sleep(0.4f);
 			FHttpModule::Get().GetHttpManager().Tick(-1.f);
+			FTicker::GetCoreTicker().Tick(0.4f); // Dispatches requests held back by the rate limiter
 		}
 
 		 // Run task to import po files, it will be done on the base folder and import all po files data generated after downloading data from gridly
@@ -158,16 +161,16 @@ int32 UGridlyImportExportCommandlet::Main(const FString& Params)
 
 	 if (bDoExport)
 	 {
-		 FHttpRequestCompleteDelegate ReqDelegate = GridlyProvider->CreateExportNativeCultureDelegate();
 		 const FText SlowTaskText = LOCTEXT("ExportNativeCultureForTargetToGridlyText", "Exporting native culture for target to Gridly");
 
-		 GridlyProvider->ExportForTargetToGridly(FirstLocTarget, ReqDelegate, SlowTaskText);
+		 GridlyProvider->ExportForTargetToGridly(FirstLocTarget, SlowTaskText);
 
 		 // Wait for Http requests
 		 while (GridlyProvider->HasRequestsPending())
 		 {
 			 FPlatformProcess::Sleep(0.4f);
 			 FHttpModule::Get().GetHttpManager().Tick(-1.f);
+			 FTicker::GetCoreTicker().Tick(0.4f);
 		 }
 	 }
 
@@ -4,12 +4,14 @@
 
 #include "GridlyEditor.h"
 #include "GridlyExporter.h"
+#include "GridlyExportPipeline.h"
 #include "GridlyGameSettings.h"
+#include "GridlyHttpClient.h"
+#include "GridlyHttpCompression.h"
 #include "GridlyLocalizedText.h"
 #include "GridlyLocalizedTextConverter.h"
 #include "GridlyStyle.h"
 #include "GridlyTask_DownloadLocalizedTexts.h"
-#include "HttpModule.h"
 #include "ILocalizationServiceModule.h"
 #include "LocalizationCommandletTasks.h"
 #include "LocalizationModule.h"
@@ -115,46 +117,68 @@ ELocalizationServiceOperationCommandResult::Type FGridlyLocalizationServiceProvi
 {
 	const TSharedRef<FDownloadLocalizationTargetFile, ESPMode::ThreadSafe> DownloadOperation =
 		StaticCastSharedRef<FDownloadLocalizationTargetFile>(InOperation);
-	const FString TargetCulture = DownloadOperation->GetInLocale();
 
+	ExecuteMultiCultureDownload({DownloadOperation}, InOperationCompleteDelegate);
+
+	return ELocalizationServiceOperationCommandResult::Succeeded;
+}
+
+void FGridlyLocalizationServiceProvider::ExecuteMultiCultureDownload(
+	const TArray<TSharedRef<FDownloadLocalizationTargetFile, ESPMode::ThreadSafe>>& DownloadOperations,
+	const FLocalizationServiceOperationComplete& InOperationCompleteDelegate)
+{
 	UGridlyTask_DownloadLocalizedTexts* Task = UGridlyTask_DownloadLocalizedTexts::DownloadLocalizedTexts(nullptr);
+	Task->RequestPriority = EGridlyRequestPriority::Interactive;
 
-	// On success
+	// Only the columns of the cultures being written are downloaded
+
+	for (const TSharedRef<FDownloadLocalizationTargetFile, ESPMode::ThreadSafe>& DownloadOperation : DownloadOperations)
+	{
+		Task->Cultures.AddUnique(DownloadOperation->GetInLocale());
+	}
+
+	// On success, write every culture's .po file from the same downloaded texts
 
 	Task->OnSuccessDelegate.BindLambda(
-		[DownloadOperation, InOperationCompleteDelegate, TargetCulture](const TArray<FPolyglotTextData>& PolyglotTextDatas)
+		[DownloadOperations, InOperationCompleteDelegate](const TArray<FPolyglotTextData>& PolyglotTextDatas)
 		{
-			if (PolyglotTextDatas.Num() > 0)
+			for (const TSharedRef<FDownloadLocalizationTargetFile, ESPMode::ThreadSafe>& DownloadOperation : DownloadOperations)
 			{
-				const FString AbsoluteFilePathAndName = FPaths::ConvertRelativePathToFull(
-					FPaths::ProjectDir() / DownloadOperation->GetInRelativeOutputFilePathAndName());
+				if (PolyglotTextDatas.Num() > 0)
+				{
+					const FString AbsoluteFilePathAndName = FPaths::ConvertRelativePathToFull(
+						FPaths::ProjectDir() / DownloadOperation->GetInRelativeOutputFilePathAndName());
 
-				FGridlyLocalizedTextConverter::WritePoFile(PolyglotTextDatas, TargetCulture, AbsoluteFilePathAndName);
+					FGridlyLocalizedTextConverter::WritePoFile(PolyglotTextDatas, DownloadOperation->GetInLocale(),
+						AbsoluteFilePathAndName);
 
-				// Callback
+					// Callback
 
-				InOperationCompleteDelegate.Execute(DownloadOperation, ELocalizationServiceOperationCommandResult::Succeeded);
-			}
-			else
-			{
-				DownloadOperation->SetOutErrorText(LOCTEXT("GridlyErrorParse", "Failed to parse downloaded content"));
-				InOperationCompleteDelegate.Execute(DownloadOperation, ELocalizationServiceOperationCommandResult::Failed);
+					InOperationCompleteDelegate.ExecuteIfBound(DownloadOperation,
+						ELocalizationServiceOperationCommandResult::Succeeded);
+				}
+				else
+				{
+					DownloadOperation->SetOutErrorText(LOCTEXT("GridlyErrorParse", "Failed to parse downloaded content"));
+					InOperationCompleteDelegate.ExecuteIfBound(DownloadOperation, ELocalizationServiceOperationCommandResult::Failed);
+				}
 			}
 		});
 
 	// On fail
 
 	Task->OnFailDelegate.BindLambda(
-		[DownloadOperation, InOperationCompleteDelegate](const TArray<FPolyglotTextData>& PolyglotTextDatas,
+		[DownloadOperations, InOperationCompleteDelegate](const TArray<FPolyglotTextData>& PolyglotTextDatas,
 		const FGridlyResult& Error)
 		{
-			DownloadOperation->SetOutErrorText(FText::FromString(Error.Message));
-			InOperationCompleteDelegate.Execute(DownloadOperation, ELocalizationServiceOperationCommandResult::Failed);
+			for (const TSharedRef<FDownloadLocalizationTargetFile, ESPMode::ThreadSafe>& DownloadOperation : DownloadOperations)
+			{
+				DownloadOperation->SetOutErrorText(FText::FromString(Error.Message));
+				InOperationCompleteDelegate.ExecuteIfBound(DownloadOperation, ELocalizationServiceOperationCommandResult::Failed);
+			}
 		});
 
 	Task->Activate();
-
-	return ELocalizationServiceOperationCommandResult::Succeeded;
 }
 
 bool FGridlyLocalizationServiceProvider::CanCancelOperation(
@@ -263,15 +287,17 @@ void FGridlyLocalizationServiceProvider::ImportAllCulturesForTargetFromGridly(
 		CurrentCultureDownloads.Append(Cultures);
 		SuccessfulDownloads = 0;
 
-		const float AmountOfWork = CurrentCultureDownloads.Num();
-		ImportAllCulturesForTargetFromGridlySlowTask = MakeShareable(new FScopedSlowTask(AmountOfWork,
+		ImportAllCulturesForTargetFromGridlySlowTask = MakeShareable(new FScopedSlowTask(1.f,
 			LOCTEXT("ImportAllCulturesForTargetFromGridlyText", "Importing all cultures for target from Gridly")));
 
 		ImportAllCulturesForTargetFromGridlySlowTask->MakeDialog();
 
+		// All cultures are written from a single download of the view IDs
+
+		TArray<TSharedRef<FDownloadLocalizationTargetFile, ESPMode::ThreadSafe>> DownloadOperations;
+
 		for (const FString& CultureName : Cultures)
 		{
-			ILocalizationServiceProvider& Provider = ILocalizationServiceModule::Get().GetProvider();
 			TSharedRef<FDownloadLocalizationTargetFile, ESPMode::ThreadSafe> DownloadTargetFileOp =
 				ILocalizationServiceOperation::Create<FDownloadLocalizationTargetFile>();
 			DownloadTargetFileOp->SetInTargetGuid(LocalizationTarget->Settings.Guid);
@@ -282,14 +308,15 @@ void FGridlyLocalizationServiceProvider::ImportAllCulturesForTargetFromGridly(
 			FPaths::MakePathRelativeTo(Path, *FPaths::ProjectDir());
 			DownloadTargetFileOp->SetInRelativeOutputFilePathAndName(Path);
 
-			auto OperationCompleteDelegate = FLocalizationServiceOperationComplete::CreateRaw(this,
-				&FGridlyLocalizationServiceProvider::OnImportCultureForTargetFromGridly, bIsTargetSet);
+			DownloadOperations.Add(DownloadTargetFileOp);
+		}
 
-			Provider.Execute(DownloadTargetFileOp, TArray<FLocalizationServiceTranslationIdentifier>(),
-				ELocalizationServiceOperationConcurrency::Synchronous, OperationCompleteDelegate);
+		auto OperationCompleteDelegate = FLocalizationServiceOperationComplete::CreateRaw(this,
+			&FGridlyLocalizationServiceProvider::OnImportCultureForTargetFromGridly, bIsTargetSet);
 
-			ImportAllCulturesForTargetFromGridlySlowTask->EnterProgressFrame(1.f);
-		}
+		ExecuteMultiCultureDownload(DownloadOperations, OperationCompleteDelegate);
+
+		ImportAllCulturesForTargetFromGridlySlowTask->EnterProgressFrame(1.f);
 
 		ImportAllCulturesForTargetFromGridlySlowTask.Reset();
 	}
@@ -338,28 +365,15 @@ void FGridlyLocalizationServiceProvider::OnImportCultureForTargetFromGridly(cons
 	}
 }
 
-TSharedRef<IHttpRequest, ESPMode::ThreadSafe> CreateExportRequest(const TArray<FPolyglotTextData>& PolyglotTextDatas,
-	const TSharedPtr<FLocTextHelper>& LocTextHelperPtr, bool bIncludeTargetTranslations)
+FHttpRequestPtr CreateExportRequest(const FString& JsonString, int NumEntries)
 {
-	FString JsonString;
-	FGridlyExporter::ConvertToJson(PolyglotTextDatas, bIncludeTargetTranslations, LocTextHelperPtr, JsonString);
-	UE_LOG(LogGridlyEditor, Log, TEXT("Creating export request with %d entries"), PolyglotTextDatas.Num());
+	UE_LOG(LogGridlyEditor, Log, TEXT("Creating export request with %d entries"), NumEntries);
 
 	const UGridlyGameSettings* GameSettings = GetMutableDefault<UGridlyGameSettings>();
-	const FString ApiKey = GameSettings->ExportApiKey;
-	const FString ViewId = GameSettings->ExportViewId;
+	const FString Url = FGridlyHttpClient::GetViewRecordsUrl(GameSettings->ExportViewId);
 
-	FStringFormatNamedArguments Args;
-	Args.Add(TEXT("ViewId"), *ViewId);
-	const FString Url = FString::Format(TEXT("https://api.gridly.com/v1/views/{ViewId}/records"), Args);
-
-	auto HttpRequest = FHttpModule::Get().CreateRequest();
-	HttpRequest->SetHeader(TEXT("Accept"), TEXT("application/json"));
-	HttpRequest->SetHeader(TEXT("Content-Type"), TEXT("application/json"));
-	HttpRequest->SetHeader(TEXT("Authorization"), FString::Printf(TEXT("ApiKey %s"), *ApiKey));
-	HttpRequest->SetContentAsString(JsonString);
-	HttpRequest->SetVerb(TEXT("POST"));
-	HttpRequest->SetURL(Url);
+	const FHttpRequestPtr HttpRequest = FGridlyHttpClient::CreateRequest(TEXT("POST"), Url, GameSettings->ExportApiKey);
+	FGridlyHttpCompression::SetContent(*HttpRequest, JsonString);
 
 	return HttpRequest;
 }
@@ -378,220 +392,313 @@ void FGridlyLocalizationServiceProvider::ExportNativeCultureForTargetToGridly(
 		ULocalizationTarget* InLocalizationTarget = LocalizationTarget.Get();
 		if (InLocalizationTarget)
 		{
-			FHttpRequestCompleteDelegate ReqDelegate = FHttpRequestCompleteDelegate::CreateRaw(this,
-				&FGridlyLocalizationServiceProvider::OnExportNativeCultureForTargetToGridly);
-
 			const FText SlowTaskText = LOCTEXT("ExportNativeCultureForTargetToGridlyText",
 				"Exporting native culture for target to Gridly");
 
-			ExportForTargetToGridly(InLocalizationTarget, ReqDelegate, SlowTaskText);
+			ExportForTargetToGridly(InLocalizationTarget, SlowTaskText);
 		}
 	}
 }
 
-void FGridlyLocalizationServiceProvider::OnExportNativeCultureForTargetToGridly(FHttpRequestPtr HttpRequestPtr,
-	FHttpResponsePtr HttpResponsePtr, bool bSuccess)
+
+void FGridlyLocalizationServiceProvider::ExportTranslationsForTargetToGridly(TWeakObjectPtr<ULocalizationTarget> LocalizationTarget,
+	bool bIsTargetSet)
 {
-	if (bSuccess)
+	check(LocalizationTarget.IsValid());
+
+	const EAppReturnType::Type MessageReturn = FMessageDialog::Open(EAppMsgType::YesNo,
+		LOCTEXT("ConfirmText",
+			"This will overwrite all your source strings AND translations on Gridly with the data in your UE4 project. Are you sure you wish to export?"));
+
+	if (!bIsTargetSet && MessageReturn == EAppReturnType::Yes)
 	{
-		if (HttpResponsePtr->GetResponseCode() == EHttpResponseCodes::Ok ||
-		    HttpResponsePtr->GetResponseCode() == EHttpResponseCodes::Created)
+		ULocalizationTarget* InLocalizationTarget = LocalizationTarget.Get();
+		if (InLocalizationTarget)
 		{
-			const FString Content = HttpResponsePtr->GetContentAsString();
-			const auto JsonStringReader = TJsonReaderFactory<TCHAR>::Create(Content);
-			TArray<TSharedPtr<FJsonValue>> JsonValueArray;
-			FJsonSerializer::Deserialize(JsonStringReader, JsonValueArray);
-			ExportForTargetEntriesUpdated += JsonValueArray.Num();
+			const FText SlowTaskText = LOCTEXT("ExportTranslationsForTargetToGridlyText",
+					"Exporting source text and translations for target to Gridly");
 
-			if (!IsRunningCommandlet())
-			{
-				ExportForTargetToGridlySlowTask->EnterProgressFrame(1.f);
-			}
+			ExportForTargetToGridly(InLocalizationTarget, SlowTaskText, true);
+		}
+	}
+}
 
-			TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> HttpRequest;
-			if (ExportFromTargetRequestQueue.Dequeue(HttpRequest))
-			{
-				HttpRequest->ProcessRequest();
-			}
-			else
+
+void FGridlyLocalizationServiceProvider::ExportForTargetToGridly(ULocalizationTarget* InLocalizationTarget, const FText& SlowTaskText, bool bIncTargetTranslation)
+{
+	FinishExport();
+
+	if (FGridlyLocalizedText::GetAllTextAsPolyglotTextDatas(InLocalizationTarget, ExportPolyglotTextDatas, ExportLocTextHelperPtr))
+	{
+		const UGridlyGameSettings* GameSettings = GetMutableDefault<UGridlyGameSettings>();
+
+		ExportRecordBuilder = MakeShared<FGridlyPolyglotRecordBuilder>(bIncTargetTranslation, ExportLocTextHelperPtr);
+
+		if (GameSettings->bExportChangedRecordsOnly)
+		{
+			RemoveUnchangedExportTexts();
+
+			if (ExportPolyglotTextDatas.Num() == 0)
 			{
-				const FString Message = FString::Printf(TEXT("Number of entries updated: %llu"),
-					ExportForTargetEntriesUpdated);
+				const FString Message = TEXT("No changes to export, all records are up to date");
 				UE_LOG(LogGridlyEditor, Log, TEXT("%s"), *Message);
 
 				if (!IsRunningCommandlet())
 				{
 					FMessageDialog::Open(EAppMsgType::Ok, FText::FromString(Message));
-					ExportForTargetToGridlySlowTask.Reset();
 				}
 
-				bExportRequestInProgress = false;
+				FinishExport();
+				return;
 			}
 		}
-		else
-		{
-			const FString Content = HttpResponsePtr->GetContentAsString();
-			const FString ErrorReason =
-				FString::Printf(TEXT("Error: %d, reason: %s"), HttpResponsePtr->GetResponseCode(), *Content);
-			UE_LOG(LogGridlyEditor, Error, TEXT("%s"), *ErrorReason);
 
+		// Chunks are index ranges into the gathered texts, each request body is only built once the chunk has a slot
+
+		BuildExportChunks();
+
+		const int TotalRequests = FMath::Max(ExportChunkStartIndices.Num() - 1, 0);
+		ExportChunkEntriesUpdated.Init(0, TotalRequests);
+
+		if (TotalRequests > 0)
+		{
 			if (!IsRunningCommandlet())
 			{
-				FMessageDialog::Open(EAppMsgType::Ok, FText::FromString(ErrorReason));
-				ExportForTargetToGridlySlowTask.Reset();
+				ExportForTargetToGridlySlowTask = MakeShareable(new FScopedSlowTask(static_cast<float>(TotalRequests), SlowTaskText));
+				ExportForTargetToGridlySlowTask->MakeDialog();
 			}
 
-			bExportRequestInProgress = false;
+			ExportPipeline = MakeShared<FGridlyExportPipeline>(TotalRequests,
+				FGridlyCreateExportRequestDelegate::CreateRaw(this, &FGridlyLocalizationServiceProvider::CreateExportRequestForChunk));
+			ExportPipeline->OnChunkComplete.BindRaw(this, &FGridlyLocalizationServiceProvider::OnExportChunkComplete);
+			ExportPipeline->OnFinished.BindRaw(this, &FGridlyLocalizationServiceProvider::OnExportFinished);
+			ExportPipeline->Start();
 		}
-	}
-	else
-	{
-		if (!IsRunningCommandlet())
+		else
 		{
-			FMessageDialog::Open(EAppMsgType::Ok, LOCTEXT("GridlyConnectionError", "ERROR: Unable to connect to Gridly"));
-			ExportForTargetToGridlySlowTask.Reset();
+			FinishExport();
 		}
-
-		bExportRequestInProgress = false;
 	}
 }
 
-void FGridlyLocalizationServiceProvider::ExportTranslationsForTargetToGridly(TWeakObjectPtr<ULocalizationTarget> LocalizationTarget,
-	bool bIsTargetSet)
+void FGridlyLocalizationServiceProvider::RemoveUnchangedExportTexts()
 {
-	check(LocalizationTarget.IsValid());
+	const UGridlyGameSettings* GameSettings = GetMutableDefault<UGridlyGameSettings>();
+	bExportChangedCellsOnly = GameSettings->bExportChangedCellsOnly;
 
-	const EAppReturnType::Type MessageReturn = FMessageDialog::Open(EAppMsgType::YesNo,
-		LOCTEXT("ConfirmText",
-			"This will overwrite all your source strings AND translations on Gridly with the data in your UE4 project. Are you sure you wish to export?"));
+	ExportLedger = MakeShared<FGridlyExportLedger>();
+	ExportLedger->Load(GameSettings->ExportViewId);
 
-	if (!bIsTargetSet && MessageReturn == EAppReturnType::Yes)
+	// Records are built the same way as for the request body, so the hashes cover exactly what would be sent, and their size
+	// is what chunks are packed by
+
+	const int NumTexts = ExportPolyglotTextDatas.Num();
+	int NumChanged = 0;
+
+	FGridlyExportRecord Record;
+	FGridlyExportLedger::FCellHashes CellHashes;
+	FGridlyExportLedger::FCellHashes ChangedCellHashes;
+	ExportCellHashes.Reset(NumTexts);
+	ExportRecordSizes.Reset(NumTexts);
+
+	for (int i = 0; i < NumTexts; i++)
 	{
-		ULocalizationTarget* InLocalizationTarget = LocalizationTarget.Get();
-		if (InLocalizationTarget)
+		ExportRecordBuilder->Build(ExportPolyglotTextDatas[i], Record);
+		FGridlyExportLedger::HashRecord(Record, CellHashes);
+
+		// With bExportChangedCellsOnly the unchanged cells are left out, they are neither sent nor committed again
+
+		const bool bChanged = bExportChangedCellsOnly
+			? ExportLedger->GetChangedCells(Record.Id, CellHashes, ChangedCellHashes)
+			: ExportLedger->HasChanged(Record.Id, CellHashes);
+
+		if (bChanged)
 		{
-			FHttpRequestCompleteDelegate ReqDelegate = FHttpRequestCompleteDelegate::CreateRaw(this,
-				&FGridlyLocalizationServiceProvider::OnExportTranslationsForTargetToGridly);
+			if (NumChanged != i)
+			{
+				ExportPolyglotTextDatas[NumChanged] = MoveTemp(ExportPolyglotTextDatas[i]);
+			}
 
-			const FText SlowTaskText = LOCTEXT("ExportTranslationsForTargetToGridlyText",
-					"Exporting source text and translations for target to Gridly");
+			ExportCellHashes.Add(MoveTemp(bExportChangedCellsOnly ? ChangedCellHashes : CellHashes));
 
-			ExportForTargetToGridly(InLocalizationTarget, ReqDelegate, SlowTaskText, true);
+			FilterExportRecord(NumChanged, Record);
+			ExportRecordSizes.Add(FGridlyExporter::EstimateJsonSize(Record) + 1);
+
+			NumChanged++;
 		}
 	}
+
+	ExportPolyglotTextDatas.RemoveAt(NumChanged, NumTexts - NumChanged);
+
+	UE_LOG(LogGridlyEditor, Log, TEXT("Exporting %d of %d records, the others are unchanged since the last export"), NumChanged,
+		NumTexts);
 }
 
-void FGridlyLocalizationServiceProvider::OnExportTranslationsForTargetToGridly(FHttpRequestPtr HttpRequestPtr,
-	FHttpResponsePtr HttpResponsePtr, bool bSuccess)
+void FGridlyLocalizationServiceProvider::FilterExportRecord(int Index, FGridlyExportRecord& Record) const
 {
-	if (bSuccess)
+	if (ExportLedger.IsValid() && bExportChangedCellsOnly)
 	{
-		if (HttpResponsePtr->GetResponseCode() == EHttpResponseCodes::Ok ||
-		    HttpResponsePtr->GetResponseCode() == EHttpResponseCodes::Created)
-		{
-			const FString Content = HttpResponsePtr->GetContentAsString();
-			const auto JsonStringReader = TJsonReaderFactory<TCHAR>::Create(Content);
-			TArray<TSharedPtr<FJsonValue>> JsonValueArray;
-			FJsonSerializer::Deserialize(JsonStringReader, JsonValueArray);
-			ExportForTargetEntriesUpdated += JsonValueArray.Num();
+		// Only the cells that differ from the ledger are sent, the record ID and path are always kept
 
-			if (!IsRunningCommandlet())
+		const FGridlyExportLedger::FCellHashes& ChangedCellHashes = ExportCellHashes[Index];
+		Record.Cells.RemoveAll([&ChangedCellHashes](const FGridlyExportCell& Cell)
+		{
+			return !ChangedCellHashes.ContainsByPredicate([&Cell](const TPair<FString, uint32>& CellHash)
 			{
-				ExportForTargetToGridlySlowTask->EnterProgressFrame(1.f);
-			}
+				return CellHash.Key == Cell.ColumnId;
+			});
+		});
+	}
+}
 
-			TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> HttpRequest;
-			if (ExportFromTargetRequestQueue.Dequeue(HttpRequest))
-			{
-				HttpRequest->ProcessRequest();
-			}
-			else
-			{
-				const FString Message = FString::Printf(TEXT("Number of entries updated: %llu"),
-					ExportForTargetEntriesUpdated);
-				UE_LOG(LogGridlyEditor, Log, TEXT("%s"), *Message);
+void FGridlyLocalizationServiceProvider::BuildExportChunks()
+{
+	const UGridlyGameSettings* GameSettings = GetMutableDefault<UGridlyGameSettings>();
+	const int MaxRecords = FMath::Max(1, GameSettings->ExportMaxRecordsPerRequest);
+	const int64 MaxBytes = GameSettings->ExportMaxBytesPerRequest;
 
-				if (!IsRunningCommandlet())
-				{
-					FMessageDialog::Open(EAppMsgType::Ok, FText::FromString(Message));
-					ExportForTargetToGridlySlowTask.Reset();
-				}
+	// Records are packed by the estimated size of what will actually be sent. A record larger than the budget still gets a
+	// chunk of its own
 
-				bExportRequestInProgress = false;
-			}
+	ExportChunkStartIndices.Reset();
+
+	FGridlyExportRecord Record;
+	int ChunkRecords = 0;
+	int64 ChunkBytes = 0;
+
+	for (int i = 0; i < ExportPolyglotTextDatas.Num(); i++)
+	{
+		int64 RecordBytes = 0;
+		if (MaxBytes > 0 && ExportRecordSizes.IsValidIndex(i))
+		{
+			RecordBytes = ExportRecordSizes[i];
 		}
-		else
+		else if (MaxBytes > 0)
 		{
-			const FString Content = HttpResponsePtr->GetContentAsString();
-			const FString ErrorReason =
-				FString::Printf(TEXT("Error: %d, reason: %s"), HttpResponsePtr->GetResponseCode(), *Content);
-			UE_LOG(LogGridlyEditor, Error, TEXT("%s"), *ErrorReason);
-
-			if (!IsRunningCommandlet())
-			{
-				FMessageDialog::Open(EAppMsgType::Ok, FText::FromString(ErrorReason));
-				ExportForTargetToGridlySlowTask.Reset();
-			}
+			ExportRecordBuilder->Build(ExportPolyglotTextDatas[i], Record);
+			FilterExportRecord(i, Record);
+			RecordBytes = FGridlyExporter::EstimateJsonSize(Record) + 1;
+		}
 
-			bExportRequestInProgress = false;
+		const bool bChunkFull = ChunkRecords >= MaxRecords
+		                        || (MaxBytes > 0 && ChunkRecords > 0 && ChunkBytes + RecordBytes > MaxBytes);
+		if (i == 0 || bChunkFull)
+		{
+			ExportChunkStartIndices.Add(i);
+			ChunkRecords = 0;
+			ChunkBytes = 2;
 		}
+
+		ChunkRecords++;
+		ChunkBytes += RecordBytes;
 	}
-	else
+
+	if (ExportChunkStartIndices.Num() > 0)
 	{
-		if (!IsRunningCommandlet())
+		ExportChunkStartIndices.Add(ExportPolyglotTextDatas.Num());
+	}
+
+	UE_LOG(LogGridlyEditor, Log, TEXT("Exporting %d records in %d requests"), ExportPolyglotTextDatas.Num(),
+		FMath::Max(ExportChunkStartIndices.Num() - 1, 0));
+}
+
+FHttpRequestPtr FGridlyLocalizationServiceProvider::CreateExportRequestForChunk(int ChunkIndex)
+{
+	const int StartIndex = ExportChunkStartIndices[ChunkIndex];
+	const int ChunkSize = ExportChunkStartIndices[ChunkIndex + 1] - StartIndex;
+	const TArrayView<const FPolyglotTextData> ChunkPolyglotTextDatas =
+		MakeArrayView(ExportPolyglotTextDatas).Slice(StartIndex, ChunkSize);
+
+	FGridlyExporter::ConvertToJson(ChunkPolyglotTextDatas, *ExportRecordBuilder, ExportJsonString,
+		[this, StartIndex](int Index, FGridlyExportRecord& Record)
 		{
-			FMessageDialog::Open(EAppMsgType::Ok, LOCTEXT("GridlyConnectionError", "ERROR: Unable to connect to Gridly"));
-			ExportForTargetToGridlySlowTask.Reset();
+			FilterExportRecord(StartIndex + Index, Record);
+		});
+
+	return CreateExportRequest(ExportJsonString, ChunkSize);
+}
+
+void FGridlyLocalizationServiceProvider::OnExportChunkComplete(int ChunkIndex, FHttpResponsePtr HttpResponsePtr)
+{
+	const FString Content = FGridlyHttpCompression::GetContentAsString(HttpResponsePtr);
+	const auto JsonStringReader = TJsonReaderFactory<TCHAR>::Create(Content);
+	TArray<TSharedPtr<FJsonValue>> JsonValueArray;
+	FJsonSerializer::Deserialize(JsonStringReader, JsonValueArray);
+	ExportChunkEntriesUpdated[ChunkIndex] = JsonValueArray.Num();
+
+	if (ExportLedger.IsValid())
+	{
+		for (int i = ExportChunkStartIndices[ChunkIndex]; i < ExportChunkStartIndices[ChunkIndex + 1]; i++)
+		{
+			ExportLedger->Commit(ExportRecordBuilder->GetRecordId(ExportPolyglotTextDatas[i]), ExportCellHashes[i]);
 		}
+	}
 
-		bExportRequestInProgress = false;
+	if (!IsRunningCommandlet())
+	{
+		ExportForTargetToGridlySlowTask->EnterProgressFrame(1.f);
 	}
 }
 
-void FGridlyLocalizationServiceProvider::ExportForTargetToGridly(ULocalizationTarget* InLocalizationTarget, FHttpRequestCompleteDelegate& ReqDelegate, const FText& SlowTaskText, bool bIncTargetTranslation)
+void FGridlyLocalizationServiceProvider::OnExportFinished(bool bSuccess, const FString& ErrorMessage)
 {
-	TArray<FPolyglotTextData> PolyglotTextDatas;
-	TSharedPtr<FLocTextHelper> LocTextHelperPtr;
-	if (FGridlyLocalizedText::GetAllTextAsPolyglotTextDatas(InLocalizationTarget, PolyglotTextDatas, LocTextHelperPtr))
+	// Chunks that made it are kept even if the export failed, so they are not sent again next time
+
+	if (ExportLedger.IsValid())
+	{
+		ExportLedger->Save();
+	}
+
+	if (bSuccess)
 	{
-		size_t TotalRequests = 0;
+		// Chunks complete in any order, so entries are totalled per chunk once all of them are done
 
-		while (PolyglotTextDatas.Num() > 0)
+		size_t ExportForTargetEntriesUpdated = 0;
+		for (const int EntriesUpdated : ExportChunkEntriesUpdated)
 		{
-			const size_t ChunkSize = FMath::Min(GetMutableDefault<UGridlyGameSettings>()->ExportMaxRecordsPerRequest, PolyglotTextDatas.Num());
-			const TArray<FPolyglotTextData> ChunkPolyglotTextDatas(PolyglotTextDatas.GetData(), ChunkSize);
-			PolyglotTextDatas.RemoveAt(0, ChunkSize);
-			const auto HttpRequest = CreateExportRequest(ChunkPolyglotTextDatas, LocTextHelperPtr, bIncTargetTranslation);
-			HttpRequest->OnProcessRequestComplete() = ReqDelegate;
-			ExportFromTargetRequestQueue.Enqueue(HttpRequest);
-			TotalRequests++;
+			ExportForTargetEntriesUpdated += EntriesUpdated;
 		}
 
-		ExportForTargetEntriesUpdated = 0;
+		const FString Message = FString::Printf(TEXT("Number of entries updated: %llu"), ExportForTargetEntriesUpdated);
+		UE_LOG(LogGridlyEditor, Log, TEXT("%s"), *Message);
 
-		TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> HttpRequest;
-		if (ExportFromTargetRequestQueue.Dequeue(HttpRequest))
+		if (!IsRunningCommandlet())
 		{
-			if (!IsRunningCommandlet())
-			{
-				ExportForTargetToGridlySlowTask = MakeShareable(new FScopedSlowTask(static_cast<float>(TotalRequests), SlowTaskText));
-				ExportForTargetToGridlySlowTask->MakeDialog();
-			}
-
-			bExportRequestInProgress = true;
-			HttpRequest->ProcessRequest();
+			FMessageDialog::Open(EAppMsgType::Ok, FText::FromString(Message));
 		}
 	}
+	else if (!IsRunningCommandlet())
+	{
+		FMessageDialog::Open(EAppMsgType::Ok, FText::FromString(ErrorMessage));
+	}
+
+	ExportForTargetToGridlySlowTask.Reset();
+	FinishExport();
 }
 
-bool FGridlyLocalizationServiceProvider::HasRequestsPending() const
+void FGridlyLocalizationServiceProvider::FinishExport()
 {
-	return !ExportFromTargetRequestQueue.IsEmpty() || bExportRequestInProgress;
+	if (ExportPipeline.IsValid())
+	{
+		ExportPipeline->Cancel();
+		ExportPipeline.Reset();
+	}
+
+	ExportPolyglotTextDatas.Empty();
+	ExportLocTextHelperPtr.Reset();
+	ExportRecordBuilder.Reset();
+	ExportChunkStartIndices.Empty();
+	ExportJsonString.Empty();
+	ExportChunkEntriesUpdated.Empty();
+	ExportLedger.Reset();
+	ExportCellHashes.Empty();
+	bExportChangedCellsOnly = false;
+	ExportRecordSizes.Empty();
 }
 
-FHttpRequestCompleteDelegate FGridlyLocalizationServiceProvider::CreateExportNativeCultureDelegate()
+bool FGridlyLocalizationServiceProvider::HasRequestsPending() const
 {
-	return FHttpRequestCompleteDelegate::CreateRaw(this, &FGridlyLocalizationServiceProvider::OnExportNativeCultureForTargetToGridly);
+	return ExportPipeline.IsValid() && ExportPipeline->IsRunning();
 }
 
 #undef LOCTEXT_NAMESPACE
@@ -4,10 +4,18 @@
 
 #include "CoreMinimal.h"
 
+#include "GridlyExportLedger.h"
 #include "ILocalizationServiceOperation.h"
 #include "ILocalizationServiceProvider.h"
 #include "ILocalizationServiceState.h"
 #include "Interfaces/IHttpRequest.h"
+#include "LocalizationServiceOperations.h"
+#include "Internationalization/PolyglotTextData.h"
+
+class FGridlyExportPipeline;
+class FGridlyPolyglotRecordBuilder;
+class FLocTextHelper;
+struct FGridlyExportRecord;
 
 class FGridlyLocalizationServiceProvider final : public ILocalizationServiceProvider
 {
@@ -52,10 +60,14 @@ public:
 #endif	  // LOCALIZATION_SERVICES_WITH_SLATE
 
 	// functions to run export/import from commandlet
-	FHttpRequestCompleteDelegate CreateExportNativeCultureDelegate();
 	bool HasRequestsPending() const;
 
-	void ExportForTargetToGridly(ULocalizationTarget* LocalizationTarget, FHttpRequestCompleteDelegate& ReqDelegate, const FText& SlowTaskText, bool bIncTargetTranslation = false);
+	/** Downloads all view IDs once and writes the .po file of every operation's culture from the same result */
+	void ExecuteMultiCultureDownload(
+		const TArray<TSharedRef<FDownloadLocalizationTargetFile, ESPMode::ThreadSafe>>& DownloadOperations,
+		const FLocalizationServiceOperationComplete& InOperationCompleteDelegate);
+
+	void ExportForTargetToGridly(ULocalizationTarget* LocalizationTarget, const FText& SlowTaskText, bool bIncTargetTranslation = false);
 	
 private:
 	// Import
@@ -69,16 +81,38 @@ private:
 
 	// Export
 
-	size_t ExportForTargetEntriesUpdated;
 	TSharedPtr<FScopedSlowTask> ExportForTargetToGridlySlowTask;
-	TQueue<TSharedPtr<IHttpRequest, ESPMode::ThreadSafe>> ExportFromTargetRequestQueue;
-	bool bExportRequestInProgress = false;
+	TSharedPtr<FGridlyExportPipeline> ExportPipeline;
+
+	// Texts being exported, chunk i uploads the texts from ExportChunkStartIndices[i] up to ExportChunkStartIndices[i + 1]
+	TArray<FPolyglotTextData> ExportPolyglotTextDatas;
+	TSharedPtr<FLocTextHelper> ExportLocTextHelperPtr;
+	TSharedPtr<FGridlyPolyglotRecordBuilder> ExportRecordBuilder;
+	TArray<int> ExportChunkStartIndices;
+	FString ExportJsonString;
+	TArray<int> ExportChunkEntriesUpdated;
+
+	// Only set when exporting changed records, cell hashes are committed to the ledger as their chunk succeeds. With
+	// bExportChangedCellsOnly they only hold the changed cells, which are also the only cells sent
+	TSharedPtr<FGridlyExportLedger> ExportLedger;
+	TArray<FGridlyExportLedger::FCellHashes> ExportCellHashes;
+	bool bExportChangedCellsOnly = false;
+
+	// Estimated body size of each record, measured while the records are compared to the ledger so chunks can be packed
+	// without building them again
+	TArray<int64> ExportRecordSizes;
+
+	void RemoveUnchangedExportTexts();
+	void FilterExportRecord(int Index, FGridlyExportRecord& Record) const;
+	void BuildExportChunks();
+	FHttpRequestPtr CreateExportRequestForChunk(int ChunkIndex);
+	void OnExportChunkComplete(int ChunkIndex, FHttpResponsePtr HttpResponsePtr);
+	void OnExportFinished(bool bSuccess, const FString& ErrorMessage);
+	void FinishExport();
 
 	void ExportNativeCultureForTargetToGridly(TWeakObjectPtr<ULocalizationTarget> LocalizationTarget, bool bIsTargetSet);
-	void OnExportNativeCultureForTargetToGridly(FHttpRequestPtr HttpRequestPtr, FHttpResponsePtr HttpResponsePtr, bool bSuccess);
 
 	// Export all
 
 	void ExportTranslationsForTargetToGridly(TWeakObjectPtr<ULocalizationTarget> LocalizationTarget, bool bIsTargetSet);
-	void OnExportTranslationsForTargetToGridly(FHttpRequestPtr HttpRequestPtr, FHttpResponsePtr HttpResponsePtr, bool bSuccess);
 };
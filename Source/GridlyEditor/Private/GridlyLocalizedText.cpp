@@ -7,8 +7,28 @@
 #include "GridlyEditor.h"
 #include "LocalizationConfigurationScript.h"
 #include "LocTextHelper.h"
+#include "Async/ParallelFor.h"
 #include "Internationalization/PolyglotTextData.h"
 
+namespace GridlyLocalizedText
+{
+struct FTextId
+{
+	FLocKey Namespace;
+	FLocKey Key;
+
+	bool operator==(const FTextId& Other) const
+	{
+		return Namespace == Other.Namespace && Key == Other.Key;
+	}
+
+	friend uint32 GetTypeHash(const FTextId& TextId)
+	{
+		return HashCombine(GetTypeHash(TextId.Namespace), GetTypeHash(TextId.Key));
+	}
+};
+}
+
 bool FGridlyLocalizedText::GetAllTextAsPolyglotTextDatas(ULocalizationTarget* LocalizationTarget,
 	TArray<FPolyglotTextData>& OutPolyglotTextDatas, TSharedPtr<FLocTextHelper>& LocTextHelper)
 {
@@ -81,8 +101,11 @@ bool FGridlyLocalizedText::GetAllTextAsPolyglotTextDatas(ULocalizationTarget* Lo
 		}
 	}
 
+	// Index of each text in OutPolyglotTextDatas, so translations can be merged without searching
+	TMap<GridlyLocalizedText::FTextId, int32> TextIndices;
+
 	LocTextHelper->EnumerateSourceTexts(
-		[&LocTextHelper, &OutPolyglotTextDatas, &NativeCulture](TSharedRef<FManifestEntry> InManifestEntry)
+		[&LocTextHelper, &OutPolyglotTextDatas, &TextIndices, &NativeCulture](TSharedRef<FManifestEntry> InManifestEntry)
 		{
 			for (const FManifestContext& Context : InManifestEntry->Contexts)
 			{
@@ -96,30 +119,56 @@ bool FGridlyLocalizedText::GetAllTextAsPolyglotTextDatas(ULocalizationTarget* Lo
 
 				FPolyglotTextData PolyglotTextData(ELocalizedTextSourceCategory::Game, SourceNamespace, SourceKey, SourceText,
 					NativeCulture);
-				OutPolyglotTextDatas.Add(PolyglotTextData);
+				const int32 TextIndex = OutPolyglotTextDatas.Add(PolyglotTextData);
+
+				// The first text wins if a key appears in several contexts
+				const GridlyLocalizedText::FTextId TextId{InManifestEntry->Namespace, Context.Key};
+				if (!TextIndices.Contains(TextId))
+				{
+					TextIndices.Add(TextId, TextIndex);
+				}
 			}
 			return true;
 		}, true);
 
+	TArray<FString> TranslatedCultures;
 	for (int i = 0; i < CulturesToGenerate.Num(); i++)
 	{
-		const FString CultureName = CulturesToGenerate[i];
-		if (CultureName != NativeCulture)
+		if (CulturesToGenerate[i] != NativeCulture)
 		{
-			LocTextHelper->EnumerateTranslations(CultureName,
-				[&CultureName, &OutPolyglotTextDatas](TSharedRef<FArchiveEntry> InManifestEntry)
+			TranslatedCultures.Add(CulturesToGenerate[i]);
+		}
+	}
+
+	// Archives are enumerated concurrently, one culture per task. Each task only reads from the loc text helper and writes
+	// to its own list, which are merged in culture order afterwards so the result does not depend on scheduling.
+	// Dependencies are not checked here, as texts found in dependencies were already left out of the index above
+
+	TArray<TArray<TPair<int32, const FString*>>> CultureTranslations;
+	CultureTranslations.SetNum(TranslatedCultures.Num());
+
+	ParallelFor(TranslatedCultures.Num(), [&LocTextHelper, &TranslatedCultures, &TextIndices, &CultureTranslations](int32 i)
+	{
+		TArray<TPair<int32, const FString*>>& Translations = CultureTranslations[i];
+
+		LocTextHelper->EnumerateTranslations(TranslatedCultures[i],
+			[&TextIndices, &Translations](TSharedRef<FArchiveEntry> InManifestEntry)
+			{
+				const int32* TextIndex = TextIndices.Find(GridlyLocalizedText::FTextId{InManifestEntry->Namespace,
+					InManifestEntry->Key});
+				if (TextIndex)
 				{
-					FPolyglotTextData* PolyglotTextData = OutPolyglotTextDatas.FindByPredicate(
-						[&InManifestEntry](const FPolyglotTextData& PolyglotTextData)
-						{
-							return PolyglotTextData.GetKey() == InManifestEntry->Key.GetString();
-						});
-					if (PolyglotTextData)
-					{
-						PolyglotTextData->AddLocalizedString(CultureName, InManifestEntry->Translation.Text);
-					}
-					return true;
-				}, true);
+					Translations.Emplace(*TextIndex, &InManifestEntry->Translation.Text);
+				}
+				return true;
+			}, false);
+	});
+
+	for (int i = 0; i < TranslatedCultures.Num(); i++)
+	{
+		for (const TPair<int32, const FString*>& Translation : CultureTranslations[i])
+		{
+			OutPolyglotTextDatas[Translation.Key].AddLocalizedString(TranslatedCultures[i], *Translation.Value);
 		}
 	}
 